@@ -0,0 +1,311 @@
+/**
+ * @file bench.c
+ * @brief Throughput benchmark of the stepping engines.
+ *
+ * Every engine is run over a matrix of grid sizes and starting patterns: random soups of
+ * several densities and the RLE files bundled in the patterns directory. Each run is warmed up
+ * first, then timed over a number of repetitions of the same number of generations, and the
+ * median and 95th percentile repetition times are reported.
+ *
+ * Results are printed as CSV, one row per engine and case, so that runs of different versions
+ * can be compared by script. Build with `make bench`; `./bench --help` lists the options.
+ */
+
+#include <SDL3/SDL.h> // for SDL timers and directory listing
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "life_engine.h" // for the grid and stepping engines
+#include "life_random.h" // for the random soups
+#include "life_rle.h" // for loading the bundled patterns
+#include "thread_pool.h" // for the number of threads reported
+
+#define BENCH_MAX_LIST 16 // Most entries in a list option such as --sizes
+#define BENCH_MAX_REPS 1000 // Most repetitions per case
+
+/**
+ * @struct BenchOptions
+ * @brief Benchmark settings parsed from the command line.
+ */
+
+struct BenchOptions {
+    int sizes[BENCH_MAX_LIST]; // Grid side lengths in cells (grids are square)
+    int size_count; // Number of entries in `sizes`
+    double densities[BENCH_MAX_LIST]; // Fractions of live cells in the random soups
+    int density_count; // Number of entries in `densities`
+    char engines[256]; // Comma-separated engine names, or empty for every engine
+    char patterns[256]; // Directory holding the RLE patterns, or empty to skip them
+    enum LifeTopology topology; // How the grid edges connect
+    int threads; // Simulation worker threads (0 = one per logical CPU core)
+    int warmup; // Generations advanced before timing
+    int reps; // Timed repetitions per case
+    uint64_t generations; // Generations advanced per repetition
+};
+
+/**
+ * @struct BenchCase
+ * @brief One starting pattern: a random soup or an RLE file.
+ */
+
+struct BenchCase {
+    const char *name; // Name printed in the results ("random" or the file name)
+    const char *path; // RLE file to load, or NULL for a random soup
+    double density; // Fraction of live cells of a random soup
+};
+
+/* --------------------------------------------------------------------------------------------
+ * Setup
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Creates the starting grid of a case.
+ * @return true if the grid is ready, false otherwise.
+ */
+
+static bool bench_setup(struct LifeGrid *g, const struct BenchOptions *opts,
+                        const struct BenchCase *c, int size) {
+    if (!life_grid_init(g, size, size)) return false;
+    life_grid_set_topology(g, opts -> topology);
+    if (!c->path) {
+        life_grid_randomize(g, c->density, (uint64_t) size);
+        return true;
+    }
+    // Patterns are centred; their header may switch the rule
+    int width = 0, height = 0;
+    life_rle_dimensions(c->path, &width, &height);
+    return life_rle_load(g, c->path, (size - width) / 2, (size - height) / 2);
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Measurement
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Orders repetition times for qsort().
+ */
+
+static int bench_compare(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Benchmarks one engine on one case and prints its result row.
+ * @return true if the case ran, false if its grid could not be set up.
+ */
+
+static bool bench_run(const struct BenchOptions *opts, const struct LifeEngine *engine,
+                      const struct BenchCase *c, int size) {
+    // Engines cache the universe between calls; a fresh grid must not be mistaken for the last
+    if (engine->reset) engine->reset();
+    life_engine_select(engine->name);
+
+    struct LifeGrid g = {0};
+    if (!bench_setup(&g, opts, c, size)) {
+        fprintf(stderr, "Skipping %s on %dx%d: %s\n", c->name, size, size, SDL_GetError());
+        life_grid_free(&g);
+        return false;
+    }
+    life_engine_advance(&g, (uint64_t) opts -> warmup);
+
+    double seconds[BENCH_MAX_REPS];
+    for (int r = 0; r < opts -> reps; r++) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        life_engine_advance(&g, opts -> generations);
+        seconds[r] = (double) (SDL_GetPerformanceCounter() - start) /
+                     (double) SDL_GetPerformanceFrequency();
+    }
+    qsort(seconds, (size_t) opts -> reps, sizeof(double), bench_compare);
+    int p95_index = (95 * opts -> reps + 99) / 100 - 1;
+    int middle = opts -> reps / 2;
+    double median = opts -> reps % 2 ? seconds[middle]
+                                     : (seconds[middle - 1] + seconds[middle]) / 2;
+    double p95 = seconds[p95_index];
+    double rate = median > 0 ? (double) opts -> generations / median : 0;
+    double p95_rate = p95 > 0 ? (double) opts -> generations / p95 : 0;
+
+    printf("%s,%s,%s,%g,%d,%d,%s,%d,%d,%d,%llu,%.9f,%.9f,%.1f,%.1f,%.0f,%llu\n",
+           engine->name, life_engine_kernel_name(), c->name, c->path ? 0.0 : c->density, size,
+           size, life_topology_names[opts -> topology], thread_pool_size(), opts -> warmup,
+           opts -> reps, (unsigned long long) opts -> generations, median, p95, rate, p95_rate,
+           rate * size * size, (unsigned long long) life_grid_population(&g));
+    fflush(stdout);
+    life_grid_free(&g);
+    return true;
+}
+
+/**
+ * @brief Returns true if the engine was asked for with --engines.
+ */
+
+static bool bench_wants_engine(const struct BenchOptions *opts, const char *name) {
+    if (!opts -> engines[0]) return true;
+    size_t length = strlen(name);
+    for (const char *p = opts -> engines; (p = strstr(p, name)); p += length) {
+        bool starts = p == opts -> engines || p[-1] == ',';
+        if (starts && (p[length] == ',' || p[length] == '\0')) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Orders file names for qsort().
+ */
+
+static int bench_compare_names(const void *a, const void *b) {
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Command-Line Options
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Prints the supported command-line options.
+ */
+
+static void bench_usage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --sizes N,...      Square grid sizes in cells (default: 256,1024,4096)\n");
+    fprintf(stderr, "  --densities D,...  Live fractions of random soups (default: 0.1,0.3,0.5)\n");
+    fprintf(stderr, "  --patterns DIR     RLE pattern directory, or none (default: patterns)\n");
+    fprintf(stderr, "  --engines NAME,... Engines to run (default: all)\n");
+    fprintf(stderr, "  --topology NAME    Grid edges: dead, torus (default) or klein\n");
+    fprintf(stderr, "  --threads N        Simulation worker threads (default: one per CPU core)\n");
+    fprintf(stderr, "  --warmup N         Generations advanced before timing (default: 16)\n");
+    fprintf(stderr, "  --reps N           Timed repetitions per case (default: 9)\n");
+    fprintf(stderr, "  --generations N    Generations per repetition (default: 32)\n");
+}
+
+/**
+ * @brief Parses a comma-separated list of numbers into `values`.
+ * @return The number of values, or 0 if the list is invalid.
+ */
+
+static int bench_parse_list(const char *text, double *values, double min, double max) {
+    int count = 0;
+    while (*text && count < BENCH_MAX_LIST) {
+        char *end;
+        double value = strtod(text, &end);
+        if (end == text || value < min || value > max || (*end && *end != ',')) return 0;
+        values[count++] = value;
+        text = *end ? end + 1 : end;
+    }
+    return *text ? 0 : count;
+}
+
+/**
+ * @brief Parses the command-line arguments into `opts`.
+ * @return true if all arguments were valid, false otherwise.
+ */
+
+static bool bench_parse_options(int argc, char *argv[], struct BenchOptions *opts) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) return false;
+        if (strncmp(argv[i], "--", 2) != 0 || i + 1 >= argc) {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+        const char *name = argv[i] + 2, *value = argv[++i];
+        double list[BENCH_MAX_LIST];
+        if (strcmp(name, "sizes") == 0) {
+            opts -> size_count = bench_parse_list(value, list, 1, LIFE_MAX_DIMENSION);
+            for (int k = 0; k < opts -> size_count; k++) opts -> sizes[k] = (int) list[k];
+            if (!opts -> size_count) {
+                fprintf(stderr, "Invalid grid sizes: %s\n", value);
+                return false;
+            }
+        } else if (strcmp(name, "densities") == 0) {
+            opts -> density_count = bench_parse_list(value, opts -> densities, 0, 1);
+            if (!opts -> density_count) {
+                fprintf(stderr, "Invalid densities: %s\n", value);
+                return false;
+            }
+        } else if (strcmp(name, "patterns") == 0) {
+            SDL_strlcpy(opts -> patterns, strcmp(value, "none") == 0 ? "" : value,
+                        sizeof(opts -> patterns));
+        } else if (strcmp(name, "engines") == 0) {
+            SDL_strlcpy(opts -> engines, value, sizeof(opts -> engines));
+        } else if (strcmp(name, "topology") == 0) {
+            if (!life_topology_parse(value, &opts -> topology)) {
+                fprintf(stderr, "%s\n", SDL_GetError());
+                return false;
+            }
+        } else if (strcmp(name, "threads") == 0 || strcmp(name, "warmup") == 0 ||
+                   strcmp(name, "reps") == 0 || strcmp(name, "generations") == 0) {
+            // Repetitions and generations must be positive, threads and warmup may be 0
+            char *end;
+            long long number = strtoll(value, &end, 10);
+            long long min = name[0] == 'r' || name[0] == 'g' ? 1 : 0;
+            long long max = name[0] == 'r' ? BENCH_MAX_REPS : 1 << 30;
+            if (end == value || *end || number < min || number > max) {
+                fprintf(stderr, "Invalid %s: %s\n", name, value);
+                return false;
+            }
+            if (name[0] == 't') opts -> threads = (int) number;
+            if (name[0] == 'w') opts -> warmup = (int) number;
+            if (name[0] == 'r') opts -> reps = (int) number;
+            if (name[0] == 'g') opts -> generations = (uint64_t) number;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", name);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Program Entry Point
+ * -------------------------------------------------------------------------------------------- */
+
+int main(int argc, char *argv[]) {
+    struct BenchOptions opts = {
+        .sizes = {256, 1024, 4096}, .size_count = 3,
+        .densities = {0.1, 0.3, 0.5}, .density_count = 3,
+        .patterns = "patterns", .topology = LIFE_TOPOLOGY_TORUS,
+        .warmup = 16, .reps = 9, .generations = 32,
+    };
+    if (!bench_parse_options(argc, argv, &opts)) {
+        bench_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!life_engine_set_threads(opts.threads)) {
+        fprintf(stderr, "Failed to start worker threads, stepping on one thread: %s\n",
+                SDL_GetError());
+    }
+
+    // Random soups first, then every bundled pattern in name order
+    struct BenchCase cases[BENCH_MAX_LIST + 64];
+    char paths[64][512];
+    int case_count = 0;
+    for (int d = 0; d < opts.density_count; d++) {
+        cases[case_count++] = (struct BenchCase) {"random", NULL, opts.densities[d]};
+    }
+    int file_count = 0;
+    char **files = opts.patterns[0] ? SDL_GlobDirectory(opts.patterns, "*.rle", 0, &file_count)
+                                    : NULL;
+    if (opts.patterns[0] && !files) {
+        fprintf(stderr, "Cannot list patterns in %s: %s\n", opts.patterns, SDL_GetError());
+    }
+    if (files) qsort(files, (size_t) file_count, sizeof(char *), bench_compare_names);
+    for (int f = 0; f < file_count && f < 64; f++) {
+        SDL_snprintf(paths[f], sizeof(paths[f]), "%s/%s", opts.patterns, files[f]);
+        cases[case_count++] = (struct BenchCase) {files[f], paths[f], 0};
+    }
+
+    printf("engine,kernel,pattern,density,width,height,topology,threads,warmup,reps,generations,"
+           "median_seconds,p95_seconds,generations_per_second,p95_generations_per_second,"
+           "cell_updates_per_second,final_population\n");
+    for (int e = 0; e < life_engine_count; e++) {
+        if (!bench_wants_engine(&opts, life_engines[e].name)) continue;
+        for (int s = 0; s < opts.size_count; s++) {
+            for (int c = 0; c < case_count; c++) {
+                bench_run(&opts, &life_engines[e], &cases[c], opts.sizes[s]);
+            }
+        }
+    }
+
+    SDL_free(files);
+    life_engine_shutdown();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,559 @@
+/**
+ * @file hashlife.c
+ * @brief HashLife engine: quadtree memoization with power-of-two generation jumps.
+ *
+ * Every quadtree node is stored exactly once in a hash table keyed by its four children, so
+ * identical regions of the universe share one node. A node of level n covers 2^n x 2^n cells and
+ * caches its RESULT: the centred 2^(n-1) x 2^(n-1) square advanced by 2^j generations. Because
+ * the cache is keyed on node identity, a pattern that repeats in space or time is only ever
+ * computed once.
+ *
+ * The engine keeps its own universe between calls and only re-reads the grid when the user has
+ * edited it, merging the edited window into the universe so that off-screen cells survive.
+ */
+
+#include "hashlife.h" // for HashLife declarations
+#include <SDL3/SDL.h> // for SDL memory functions
+#include <stdlib.h>
+#include <string.h>
+
+#define HL_BLOCK_NODES 4096 // Nodes allocated per arena block
+#define HL_MAX_NODES (1 << 21) // Node count that triggers garbage collection between steps
+#define HL_MAX_LEVEL 62 // Largest level whose size still fits in an int64_t coordinate
+#define HL_NO_RESULT (-1) // `result_log2` value of a node without a cached result
+#define HL_FORWARDED (-2) // `result_log2` value of a node copied during garbage collection
+
+/* --------------------------------------------------------------------------------------------
+ * Struct Definitions
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @struct HLNode
+ * @brief A canonical quadtree node. Level 0 nodes are single cells.
+ */
+
+struct HLNode {
+    struct HLNode *nw, *ne, *sw, *se; // Quadrants (NULL for level 0)
+    struct HLNode *result; // Cached centre after 2^result_log2 generations (or forward pointer)
+    struct HLNode *next; // Next node in the same hash bucket
+    uint64_t population; // Number of live cells
+    int8_t level; // log2 of the side length
+    int8_t result_log2; // Step exponent of `result`, or HL_NO_RESULT
+};
+
+/**
+ * @struct HLBlock
+ * @brief A block of node storage. Nodes are never freed individually, only whole arenas.
+ */
+
+struct HLBlock {
+    struct HLBlock *prev; // Previously allocated block
+    int used; // Nodes handed out from this block
+    struct HLNode nodes[HL_BLOCK_NODES];
+};
+
+/**
+ * @struct HLStore
+ * @brief Hash table and arena holding all canonical nodes.
+ */
+
+struct HLStore {
+    struct HLNode **buckets; // Hash buckets (power-of-two count)
+    size_t bucket_count; // Number of buckets
+    size_t node_count; // Number of nodes in the table
+    struct HLBlock *blocks; // Most recent arena block
+    struct HLNode *empty[HL_MAX_LEVEL + 1]; // Canonical all-dead node per level, built lazily
+};
+
+/**
+ * @struct HLCell
+ * @brief Coordinates of one live cell, used when merging edits into the universe.
+ */
+
+struct HLCell {
+    int64_t x, y;
+};
+
+/* --------------------------------------------------------------------------------------------
+ * Global State
+ * -------------------------------------------------------------------------------------------- */
+
+static struct HLNode dead_cell = {NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, HL_NO_RESULT};
+static struct HLNode live_cell = {NULL, NULL, NULL, NULL, NULL, NULL, 1, 0, HL_NO_RESULT};
+
+static struct HLStore store = {0}; // Current node store
+static struct HLNode *root = NULL; // Universe root, or NULL before the first step
+static int64_t origin_x = 0; // Universe coordinates of the root's top-left cell
+static int64_t origin_y = 0;
+// Rule the cached results follow
+static struct LifeRule hl_rule = {.birth = 1 << 3, .survival = (1 << 2) | (1 << 3), .states = 2};
+static bool grid_loaded = false; // False until the universe has been read from the grid
+static uint64_t synced_edits = 0; // Grid edit counter when the universe last matched the grid
+
+/* --------------------------------------------------------------------------------------------
+ * Node Store
+ * -------------------------------------------------------------------------------------------- */
+
+static size_t hl_hash(const struct HLNode *nw, const struct HLNode *ne,
+                      const struct HLNode *sw, const struct HLNode *se) {
+    uint64_t h = (uint64_t) (uintptr_t) nw * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (uint64_t) (uintptr_t) ne) * 0xC2B2AE3D27D4EB4Full;
+    h = (h ^ (uint64_t) (uintptr_t) sw) * 0x165667B19E3779F9ull;
+    h = (h ^ (uint64_t) (uintptr_t) se) * 0x9E3779B97F4A7C15ull;
+    return (size_t) (h ^ (h >> 29));
+}
+
+static void hl_store_free(struct HLStore *s) {
+    while (s->blocks) {
+        struct HLBlock *prev = s->blocks->prev;
+        SDL_free(s->blocks);
+        s->blocks = prev;
+    }
+    SDL_free(s->buckets);
+    memset(s, 0, sizeof(*s));
+}
+
+static bool hl_store_grow(struct HLStore *s) {
+    size_t count = s->bucket_count ? s->bucket_count * 2 : 1 << 16;
+    struct HLNode **buckets = SDL_calloc(count, sizeof(*buckets));
+    if (!buckets) return false;
+    // Rehash every node into the larger table
+    for (size_t i = 0; i < s->bucket_count; i++) {
+        struct HLNode *n = s->buckets[i];
+        while (n) {
+            struct HLNode *next = n->next;
+            size_t b = hl_hash(n->nw, n->ne, n->sw, n->se) & (count - 1);
+            n->next = buckets[b];
+            buckets[b] = n;
+            n = next;
+        }
+    }
+    SDL_free(s->buckets);
+    s->buckets = buckets;
+    s->bucket_count = count;
+    return true;
+}
+
+/**
+ * @brief Returns the canonical node with the given quadrants, creating it if needed.
+ *
+ * Allocation failure is fatal for the engine, since a half-built quadtree cannot be recovered.
+ */
+
+static struct HLNode *hl_join(struct HLNode *nw, struct HLNode *ne,
+                              struct HLNode *sw, struct HLNode *se) {
+    if (store.node_count >= store.bucket_count) {
+        if (!hl_store_grow(&store)) {
+            SDL_Log("HashLife: out of memory growing the node table\n");
+            abort();
+        }
+    }
+    size_t b = hl_hash(nw, ne, sw, se) & (store.bucket_count - 1);
+    for (struct HLNode *n = store.buckets[b]; n; n = n->next) {
+        if (n->nw == nw && n->ne == ne && n->sw == sw && n->se == se) return n;
+    }
+
+    if (!store.blocks || store.blocks->used == HL_BLOCK_NODES) {
+        struct HLBlock *block = SDL_malloc(sizeof(*block));
+        if (!block) {
+            SDL_Log("HashLife: out of memory allocating nodes\n");
+            abort();
+        }
+        block->prev = store.blocks;
+        block->used = 0;
+        store.blocks = block;
+    }
+    struct HLNode *n = &store.blocks->nodes[store.blocks->used++];
+    n->nw = nw;
+    n->ne = ne;
+    n->sw = sw;
+    n->se = se;
+    n->result = NULL;
+    n->population = nw->population + ne->population + sw->population + se->population;
+    n->level = (int8_t) (nw->level + 1);
+    n->result_log2 = HL_NO_RESULT;
+    n->next = store.buckets[b];
+    store.buckets[b] = n;
+    store.node_count++;
+    return n;
+}
+
+static struct HLNode *hl_empty(int level) {
+    if (level == 0) return &dead_cell;
+    if (!store.empty[level]) {
+        struct HLNode *e = hl_empty(level - 1);
+        store.empty[level] = hl_join(e, e, e, e);
+    }
+    return store.empty[level];
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Quadtree Operations
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Returns the level n-1 node centred in a level n node.
+ */
+
+static struct HLNode *hl_centre(struct HLNode *n) {
+    return hl_join(n->nw->se, n->ne->sw, n->sw->ne, n->se->nw);
+}
+
+/**
+ * @brief Returns a node one level up with `n` in its centre and empty space around it.
+ */
+
+static struct HLNode *hl_expand(struct HLNode *n) {
+    struct HLNode *e = hl_empty(n->level - 1);
+    return hl_join(hl_join(e, e, e, n->nw), hl_join(e, e, n->ne, e),
+                   hl_join(e, n->sw, e, e), hl_join(n->se, e, e, e));
+}
+
+/**
+ * @brief Returns a copy of `n` with the cell at (x, y) relative to its corner set or cleared.
+ */
+
+static struct HLNode *hl_set_cell(struct HLNode *n, int64_t x, int64_t y, bool alive) {
+    if (n->level == 0) return alive ? &live_cell : &dead_cell;
+    int64_t half = (int64_t) 1 << (n->level - 1);
+    bool east = x >= half, south = y >= half;
+    int64_t cx = east ? x - half : x, cy = south ? y - half : y;
+    if (!south && !east) return hl_join(hl_set_cell(n->nw, cx, cy, alive), n->ne, n->sw, n->se);
+    if (!south) return hl_join(n->nw, hl_set_cell(n->ne, cx, cy, alive), n->sw, n->se);
+    if (!east) return hl_join(n->nw, n->ne, hl_set_cell(n->sw, cx, cy, alive), n->se);
+    return hl_join(n->nw, n->ne, n->sw, hl_set_cell(n->se, cx, cy, alive));
+}
+
+/**
+ * @brief Returns true if all live cells of `n` lie in its central quarter (the centre of its
+ *        centre), leaving a margin that growth during a step cannot cross.
+ */
+
+static bool hl_is_padded(struct HLNode *n) {
+    if (n->level < 3) return n->population == 0;
+    struct HLNode *inner = hl_join(n->nw->se->se, n->ne->sw->sw, n->sw->ne->ne, n->se->nw->nw);
+    return inner->population == n->population;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Successor Computation
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Advances a level 2 (4x4) node by one generation by direct neighbour counting.
+ * @return The level 1 (2x2) centre after one generation.
+ */
+
+static struct HLNode *hl_base_step(struct HLNode *n) {
+    bool cells[4][4];
+    struct HLNode *quads[2][2] = {{n->nw, n->ne}, {n->sw, n->se}};
+    for (int qy = 0; qy < 2; qy++) {
+        for (int qx = 0; qx < 2; qx++) {
+            struct HLNode *q = quads[qy][qx];
+            cells[qy * 2][qx * 2] = q->nw->population;
+            cells[qy * 2][qx * 2 + 1] = q->ne->population;
+            cells[qy * 2 + 1][qx * 2] = q->sw->population;
+            cells[qy * 2 + 1][qx * 2 + 1] = q->se->population;
+        }
+    }
+
+    struct HLNode *out[2][2];
+    for (int y = 1; y <= 2; y++) {
+        for (int x = 1; x <= 2; x++) {
+            int neighbours = 0;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (dx || dy) neighbours += cells[y + dy][x + dx];
+                }
+            }
+            uint16_t counts = cells[y][x] ? hl_rule.survival : hl_rule.birth;
+            bool alive = (counts >> neighbours) & 1;
+            out[y - 1][x - 1] = alive ? &live_cell : &dead_cell;
+        }
+    }
+    return hl_join(out[0][0], out[0][1], out[1][0], out[1][1]);
+}
+
+/**
+ * @brief Returns the centre of a level n node advanced by 2^j generations (j <= n - 2).
+ *
+ * The node is split into nine overlapping level n-1 sub-squares. When j == n - 2 they are each
+ * advanced by 2^(j-1) generations, recombined into four squares and advanced by another
+ * 2^(j-1). For smaller j the first half-step is replaced by simply taking their centres.
+ */
+
+static struct HLNode *hl_successor(struct HLNode *n, int j) {
+    if (n->population == 0) return hl_empty(n->level - 1);
+    if (n->result && n->result_log2 == j) return n->result;
+
+    struct HLNode *result;
+    if (n->level == 2) {
+        result = hl_base_step(n);
+    } else {
+        struct HLNode *sub[3][3] = {
+            {n->nw, hl_join(n->nw->ne, n->ne->nw, n->nw->se, n->ne->sw), n->ne},
+            {hl_join(n->nw->sw, n->nw->se, n->sw->nw, n->sw->ne), hl_centre(n),
+             hl_join(n->ne->sw, n->ne->se, n->se->nw, n->se->ne)},
+            {n->sw, hl_join(n->sw->ne, n->se->nw, n->sw->se, n->se->sw), n->se},
+        };
+
+        struct HLNode *r[3][3];
+        bool full_speed = (j == n->level - 2);
+        for (int y = 0; y < 3; y++) {
+            for (int x = 0; x < 3; x++) {
+                r[y][x] = full_speed ? hl_successor(sub[y][x], j - 1) : hl_centre(sub[y][x]);
+            }
+        }
+
+        int k = full_speed ? j - 1 : j;
+        result = hl_join(hl_successor(hl_join(r[0][0], r[0][1], r[1][0], r[1][1]), k),
+                         hl_successor(hl_join(r[0][1], r[0][2], r[1][1], r[1][2]), k),
+                         hl_successor(hl_join(r[1][0], r[1][1], r[2][0], r[2][1]), k),
+                         hl_successor(hl_join(r[1][1], r[1][2], r[2][1], r[2][2]), k));
+    }
+
+    n->result = result;
+    n->result_log2 = (int8_t) j;
+    return result;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Garbage Collection
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Re-interns the subtree of `n` from the old store into the current store.
+ *
+ * Copied nodes keep a forward pointer in their `result` field so shared subtrees are only
+ * copied once.
+ */
+
+static struct HLNode *hl_copy(struct HLNode *n) {
+    if (n->level == 0) return n;
+    if (n->result_log2 == HL_FORWARDED) return n->result;
+    struct HLNode *copy = hl_join(hl_copy(n->nw), hl_copy(n->ne), hl_copy(n->sw), hl_copy(n->se));
+    n->result = copy;
+    n->result_log2 = HL_FORWARDED;
+    return copy;
+}
+
+/**
+ * @brief Frees every node that is not reachable from the root, dropping cached results.
+ */
+
+static void hl_collect(void) {
+    struct HLStore old = store;
+    memset(&store, 0, sizeof(store));
+    root = hl_copy(root);
+    hl_store_free(&old);
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Grid Conversion
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Builds the node of the given level whose top-left cell is grid cell (x0, y0).
+ */
+
+static struct HLNode *hl_from_grid(const struct LifeGrid *g, int level, int64_t x0, int64_t y0) {
+    if (x0 >= g->width || y0 >= g->height) return hl_empty(level);
+    if (level == 0) return life_grid_get(g, (int) x0, (int) y0) ? &live_cell : &dead_cell;
+    int64_t half = (int64_t) 1 << (level - 1);
+    return hl_join(hl_from_grid(g, level - 1, x0, y0), hl_from_grid(g, level - 1, x0 + half, y0),
+                   hl_from_grid(g, level - 1, x0, y0 + half),
+                   hl_from_grid(g, level - 1, x0 + half, y0 + half));
+}
+
+/**
+ * @brief Writes the live cells of `n` (top-left corner at universe (x0, y0)) into the grid.
+ */
+
+static void hl_to_grid(struct HLNode *n, int64_t x0, int64_t y0, struct LifeGrid *g) {
+    int64_t size = (int64_t) 1 << n->level;
+    if (n->population == 0 || x0 >= g->width || y0 >= g->height || x0 + size <= 0 || y0 + size <= 0) {
+        return;
+    }
+    if (n->level == 0) {
+        life_grid_set(g, (int) x0, (int) y0, true);
+        return;
+    }
+    int64_t half = size / 2;
+    hl_to_grid(n->nw, x0, y0, g);
+    hl_to_grid(n->ne, x0 + half, y0, g);
+    hl_to_grid(n->sw, x0, y0 + half, g);
+    hl_to_grid(n->se, x0 + half, y0 + half, g);
+}
+
+/**
+ * @brief Appends the live cells of `n` that lie outside the grid window to `cells`.
+ */
+
+static void hl_collect_outside(struct HLNode *n, int64_t x0, int64_t y0, const struct LifeGrid *g,
+                               struct HLCell **cells, size_t *count, size_t *capacity) {
+    int64_t size = (int64_t) 1 << n->level;
+    bool inside = x0 >= 0 && y0 >= 0 && x0 + size <= g->width && y0 + size <= g->height;
+    if (n->population == 0 || inside) return;
+    if (n->level == 0) {
+        if (*count == *capacity) {
+            *capacity = *capacity ? *capacity * 2 : 256;
+            struct HLCell *grown = SDL_realloc(*cells, *capacity * sizeof(**cells));
+            if (!grown) return; // Drop the cell rather than lose the whole universe
+            *cells = grown;
+        }
+        (*cells)[(*count)++] = (struct HLCell) {x0, y0};
+        return;
+    }
+    int64_t half = size / 2;
+    hl_collect_outside(n->nw, x0, y0, g, cells, count, capacity);
+    hl_collect_outside(n->ne, x0 + half, y0, g, cells, count, capacity);
+    hl_collect_outside(n->sw, x0, y0 + half, g, cells, count, capacity);
+    hl_collect_outside(n->se, x0 + half, y0 + half, g, cells, count, capacity);
+}
+
+/**
+ * @brief Sets a cell of the universe, growing the root until the cell fits inside it.
+ */
+
+static void hl_place(int64_t x, int64_t y, bool alive) {
+    while (x < origin_x || y < origin_y || x >= origin_x + ((int64_t) 1 << root->level) ||
+           y >= origin_y + ((int64_t) 1 << root->level)) {
+        if (root->level >= HL_MAX_LEVEL) return;
+        int64_t quarter = (int64_t) 1 << (root->level - 1);
+        root = hl_expand(root);
+        origin_x -= quarter;
+        origin_y -= quarter;
+    }
+    root = hl_set_cell(root, x - origin_x, y - origin_y, alive);
+}
+
+/**
+ * @brief Rebuilds the universe from the grid window, keeping any live cells outside it.
+ */
+
+static void hl_load_grid(const struct LifeGrid *g) {
+    struct HLCell *outside = NULL;
+    size_t count = 0, capacity = 0;
+    if (root) hl_collect_outside(root, origin_x, origin_y, g, &outside, &count, &capacity);
+
+    // Smallest power-of-two square covering the grid
+    int level = 3;
+    while (((int64_t) 1 << level) < g->width || ((int64_t) 1 << level) < g->height) level++;
+    root = hl_from_grid(g, level, 0, 0);
+    origin_x = 0;
+    origin_y = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        hl_place(outside[i].x, outside[i].y, true);
+    }
+    SDL_free(outside);
+    grid_loaded = true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Engine Entry Points
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Advances the universe by exactly 2^j generations.
+ */
+
+static void hl_step_pow2(int j) {
+    // Pad until growth over 2^j generations cannot reach past the centre being computed
+    while (root->level < j + 3 || !hl_is_padded(root)) {
+        if (root->level >= HL_MAX_LEVEL) {
+            SDL_Log("HashLife: universe too large to advance by 2^%d generations\n", j);
+            return;
+        }
+        int64_t quarter = (int64_t) 1 << (root->level - 1);
+        root = hl_expand(root);
+        origin_x -= quarter;
+        origin_y -= quarter;
+    }
+
+    int64_t quarter = (int64_t) 1 << (root->level - 2);
+    root = hl_successor(root, j);
+    origin_x += quarter;
+    origin_y += quarter;
+
+    if (store.node_count > HL_MAX_NODES) hl_collect();
+}
+
+/**
+ * @brief Advances the grid by the given number of generations using HashLife.
+ *
+ * The generation count is split into powers of two, each of which is a single memoized step.
+ * The grid window is re-read only if it was edited since the last call.
+ *
+ * @param g Grid whose window is displayed; it is overwritten with the new generation.
+ * @param generations Number of generations to advance.
+ */
+
+void hashlife_advance(struct LifeGrid *g, uint64_t generations) {
+    if (g->rule.birth != hl_rule.birth || g->rule.survival != hl_rule.survival) {
+        // Every cached result was computed under the old rule
+        hl_rule = g->rule;
+        if (root) hl_collect();
+    }
+    if (!root || !grid_loaded || g->edits != synced_edits) hl_load_grid(g);
+
+    for (int j = HL_MAX_LEVEL - 3; j >= 0; j--) {
+        if (generations & ((uint64_t) 1 << j)) hl_step_pow2(j);
+    }
+
+    life_grid_clear(g);
+    hl_to_grid(root, origin_x, origin_y, g);
+    synced_edits = g->edits;
+}
+
+/**
+ * @brief Sets a cell of the universe directly, e.g. a pattern cell outside the grid window.
+ * @param x Universe X-coordinate (the grid window starts at 0).
+ * @param y Universe Y-coordinate.
+ * @param alive New state of the cell.
+ */
+
+void hashlife_set_cell(int64_t x, int64_t y, bool alive) {
+    if (!root) root = hl_empty(3);
+    hl_place(x, y, alive);
+}
+
+/**
+ * @brief Calls `visit` for every live cell under a node whose top-left cell is at (x0, y0).
+ */
+
+static void hl_visit(const struct HLNode *n, int64_t x0, int64_t y0, LifeCellVisitor visit,
+                     void *ctx) {
+    if (n->population == 0) return;
+    if (n->level == 0) {
+        visit(ctx, x0, y0);
+        return;
+    }
+    int64_t half = (int64_t) 1 << (n->level - 1);
+    hl_visit(n->nw, x0, y0, visit, ctx);
+    hl_visit(n->ne, x0 + half, y0, visit, ctx);
+    hl_visit(n->sw, x0, y0 + half, visit, ctx);
+    hl_visit(n->se, x0 + half, y0 + half, visit, ctx);
+}
+
+/**
+ * @brief Lists every live cell of the universe, inside the grid window or not.
+ * @param visit Called once per live cell.
+ * @param ctx Passed on to `visit`.
+ */
+
+void hashlife_visit_cells(LifeCellVisitor visit, void *ctx) {
+    if (root) hl_visit(root, origin_x, origin_y, visit, ctx);
+}
+
+/**
+ * @brief Discards the HashLife universe and all cached results.
+ */
+
+void hashlife_reset(void) {
+    hl_store_free(&store);
+    root = NULL;
+    grid_loaded = false;
+    origin_x = 0;
+    origin_y = 0;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file hashlife.h
+ * @brief Declarations for the HashLife stepping engine.
+ *
+ * HashLife represents the universe as a quadtree of canonicalized (hash-consed) nodes and
+ * memoizes the future of every node, so repetitive patterns can be advanced by huge powers of
+ * two in a single step. The visible grid is a window onto an unbounded plane: patterns that leave
+ * the window keep evolving off-screen instead of dying at the edge.
+ */
+
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+#include "life_engine.h" // for the grid the engine reads and writes
+#include <stdbool.h>
+#include <stdint.h>
+
+void hashlife_advance(struct LifeGrid *g, uint64_t generations);
+void hashlife_set_cell(int64_t x, int64_t y, bool alive);
+void hashlife_reset(void);
+void hashlife_visit_cells(LifeCellVisitor visit, void *ctx);
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * @file life_cycle.c
+ * @brief Cycle detection by incremental hashing of the grid.
+ *
+ * After every generation only the tiles flagged in `tile_changed` are rehashed, since no other
+ * tile changed, so watching a settled grid costs next to nothing. The grid hash is looked up in
+ * the hashes of the recent generations; a match is confirmed against a copy of the grid one
+ * period later before the grid is declared to cycle.
+ */
+
+#include "life_cycle.h" // for cycle detection declarations
+#include "thread_pool.h" // for multithreaded hashing
+#include <SDL3/SDL.h> // for SDL memory functions
+#include <string.h>
+
+// Grids smaller than this many words are hashed on the calling thread only
+#define LIFE_CYCLE_PARALLEL_MIN_WORDS 4096
+
+/**
+ * @struct LifeCycleHashJob
+ * @brief Tiles the workers rehash after a generation.
+ */
+
+struct LifeCycleHashJob {
+    struct LifeGrid *g; // Grid being hashed
+    bool all; // True to hash every tile, false to rehash only the changed ones
+};
+
+/* --------------------------------------------------------------------------------------------
+ * Hashing
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Scrambles a word so that every input bit affects every output bit (the finalizer of
+ *        splitmix64).
+ */
+
+static inline uint64_t life_cycle_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Hashes the cells of tile (tx, ty), and their states under a Generations rule.
+ *
+ * Every word is scrambled together with a key derived from its position and the results are
+ * summed, so the words are mixed independently of each other yet moving a cell changes the hash.
+ */
+
+static uint64_t life_cycle_tile_hash(const struct LifeGrid *g, int tx, int ty) {
+    uint64_t mask = tx == g->words - 1 ? g->last_mask : ~(uint64_t) 0, hash = 0;
+    int y0 = ty * LIFE_TILE_ROWS;
+    int y1 = y0 + LIFE_TILE_ROWS < g->height ? y0 + LIFE_TILE_ROWS : g->height;
+    for (int y = y0; y < y1; y++) {
+        // Multiples of the 64-bit golden ratio spread the positions over the whole word
+        uint64_t key = ((uint64_t) y * g->words + tx) * 0x9E3779B97F4A7C15ull;
+        hash += life_cycle_mix((life_grid_row(g, y)[tx] & mask) ^ key);
+        if (!g->states) continue;
+        const uint8_t *states = life_grid_state_row(g, y) + (size_t) tx * LIFE_WORD_BITS;
+        for (int k = 0; k < LIFE_WORD_BITS / 8; k++) {
+            uint64_t bytes;
+            memcpy(&bytes, states + 8 * k, sizeof(bytes));
+            hash += life_cycle_mix(bytes ^ (key + k + 1));
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Thread pool job rehashing one horizontal band of tile rows.
+ */
+
+static void life_cycle_hash_band(void *ctx, int index, int count) {
+    const struct LifeCycleHashJob *job = ctx;
+    struct LifeGrid *g = job->g;
+    struct LifeCycleDetector *cycle = &g->cycle;
+    int words = g->words;
+    int ty0 = (int) ((long long) g->tile_rows * index / count);
+    int ty1 = (int) ((long long) g->tile_rows * (index + 1) / count);
+
+    for (int ty = ty0; ty < ty1; ty++) {
+        const uint8_t *changed = g->tile_changed + (size_t) ty * words;
+        uint64_t *hashes = cycle->tile_hashes + (size_t) ty * words;
+        uint64_t row_hash = job->all ? 0 : cycle->tile_row_hashes[ty];
+        for (int tx = 0; tx < words; tx++) {
+            if (!job->all && !changed[tx]) continue;
+            uint64_t hash = life_cycle_tile_hash(g, tx, ty);
+            row_hash += hash - (job->all ? 0 : hashes[tx]);
+            hashes[tx] = hash;
+        }
+        cycle->tile_row_hashes[ty] = row_hash;
+    }
+}
+
+/**
+ * @brief Brings the tile hashes up to date and returns the grid hash.
+ * @param all True to hash every tile, false to rehash only the tiles that changed.
+ */
+
+static uint64_t life_cycle_hash(struct LifeGrid *g, bool all) {
+    struct LifeCycleHashJob job = {g, all};
+    if ((size_t) g->words * g->height < LIFE_CYCLE_PARALLEL_MIN_WORDS || thread_pool_size() == 1) {
+        life_cycle_hash_band(&job, 0, 1);
+    } else {
+        thread_pool_run(life_cycle_hash_band, &job);
+    }
+    uint64_t hash = 0;
+    for (int ty = 0; ty < g->tile_rows; ty++) hash += g->cycle.tile_row_hashes[ty];
+    return hash;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Snapshots
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Copies the current generation into the snapshot.
+ * @return true on success, false if the snapshot could not be allocated.
+ */
+
+static bool life_cycle_take_snapshot(struct LifeGrid *g) {
+    struct LifeCycleDetector *cycle = &g->cycle;
+    size_t words = (size_t) g->words, cells = words * LIFE_WORD_BITS;
+    if (!cycle->snapshot) cycle->snapshot = SDL_malloc(words * g->height * sizeof(uint64_t));
+    if (g->states && !cycle->snapshot_states) {
+        cycle->snapshot_states = SDL_malloc(cells * g->height);
+    }
+    if (!cycle->snapshot || (g->states && !cycle->snapshot_states)) return false;
+
+    for (int y = 0; y < g->height; y++) {
+        uint64_t *row = cycle->snapshot + (size_t) y * words;
+        memcpy(row, life_grid_row(g, y), words * sizeof(uint64_t));
+        // The padding bits may hold the east halo
+        row[words - 1] &= g->last_mask;
+    }
+    if (g->states) memcpy(cycle->snapshot_states, g->states, cells * g->height);
+    return true;
+}
+
+/**
+ * @brief Returns true if the current generation is identical to the snapshot.
+ */
+
+static bool life_cycle_matches_snapshot(const struct LifeGrid *g) {
+    const struct LifeCycleDetector *cycle = &g->cycle;
+    size_t words = (size_t) g->words;
+    for (int y = 0; y < g->height; y++) {
+        const uint64_t *row = life_grid_row(g, y), *saved = cycle->snapshot + (size_t) y * words;
+        if (memcmp(row, saved, (words - 1) * sizeof(uint64_t)) != 0) return false;
+        if ((row[words - 1] & g->last_mask) != saved[words - 1]) return false;
+    }
+    return !g->states ||
+           memcmp(g->states, cycle->snapshot_states, words * LIFE_WORD_BITS * g->height) == 0;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Detection
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Starts or stops watching the grid for repeated generations (see struct
+ *        LifeCycleDetector).
+ * @param g Grid to watch.
+ * @param enable True to detect cycles, false to stop and free the detector.
+ * @return true on success, false if the detector could not be allocated.
+ */
+
+bool life_grid_detect_cycles(struct LifeGrid *g, bool enable) {
+    struct LifeCycleDetector *cycle = &g->cycle;
+    if (!enable || !cycle->tile_hashes) {
+        SDL_free(cycle->tile_hashes);
+        SDL_free(cycle->tile_row_hashes);
+        SDL_free(cycle->history);
+        SDL_free(cycle->snapshot);
+        SDL_free(cycle->snapshot_states);
+        memset(cycle, 0, sizeof(*cycle));
+    }
+    if (!enable || cycle->tile_hashes) return true;
+
+    cycle->tile_hashes = SDL_calloc((size_t) g->words * g->tile_rows, sizeof(uint64_t));
+    cycle->tile_row_hashes = SDL_calloc(g->tile_rows, sizeof(uint64_t));
+    cycle->history = SDL_calloc(LIFE_CYCLE_HISTORY, sizeof(uint64_t));
+    if (!cycle->tile_hashes || !cycle->tile_row_hashes || !cycle->history) {
+        life_grid_detect_cycles(g, false);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Hashes the generation just computed and checks it against the recent ones. Called by
+ *        life_engine_advance() after every generation while cycles are detected and none is
+ *        known yet.
+ *
+ * The shortest distance back to an equal hash becomes the candidate period, and the current
+ * generation is saved. If the grid matches the saved copy exactly one candidate period later,
+ * the grid cycles with that period; it is also the shortest one, since a shorter period would
+ * have repeated a hash at a shorter distance.
+ */
+
+void life_cycle_observe(struct LifeGrid *g) {
+    struct LifeCycleDetector *cycle = &g->cycle;
+    // Edits, or generations stepped without being hashed, invalidate the history
+    bool restart = !cycle->observed || cycle->edits != g->edits ||
+                   g->generation != cycle->generation + 1;
+    if (restart) {
+        cycle->observed = 0;
+        cycle->candidate = 0;
+        cycle->period = 0;
+        cycle->edits = g->edits;
+    }
+    uint64_t hash = life_cycle_hash(g, restart), generation = g->generation;
+    cycle->generation = generation;
+
+    if (cycle->candidate && generation == cycle->snapshot_generation + cycle->candidate) {
+        if (hash == cycle->snapshot_hash && life_cycle_matches_snapshot(g)) {
+            cycle->period = cycle->candidate;
+        }
+        cycle->candidate = 0;
+    }
+    if (!cycle->period && !cycle->candidate) {
+        // The slot of this generation still holds the one LIFE_CYCLE_HISTORY generations back
+        uint64_t depth = cycle->observed;
+        if (depth > LIFE_CYCLE_HISTORY) depth = LIFE_CYCLE_HISTORY;
+        for (uint64_t d = 1; d <= depth; d++) {
+            if (cycle->history[(generation - d) % LIFE_CYCLE_HISTORY] != hash) continue;
+            if (life_cycle_take_snapshot(g)) {
+                cycle->candidate = d;
+                cycle->snapshot_hash = hash;
+                cycle->snapshot_generation = generation;
+            }
+            break;
+        }
+    }
+    cycle->history[generation % LIFE_CYCLE_HISTORY] = hash;
+    cycle->observed++;
+}
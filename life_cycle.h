@@ -0,0 +1,16 @@
+/**
+ * @file life_cycle.h
+ * @brief Internal declarations for detecting generations that repeat.
+ *
+ * Bounded grids eventually settle into still lifes and oscillators. Once the grid is proven to
+ * cycle, advancing it any number of generations only takes the remainder modulo the period.
+ */
+
+#ifndef LIFE_CYCLE_H
+#define LIFE_CYCLE_H
+
+#include "life_engine.h" // for the grid being watched
+
+void life_cycle_observe(struct LifeGrid *g);
+
+#endif
@@ -0,0 +1,1080 @@
+/**
+ * @file life_engine.c
+ * @brief Bit-packed Game of Life grid storage and next-generation computation.
+ *
+ * Each row of the grid is a run of 64-bit words holding one cell per bit. The next generation is
+ * computed a whole word at a time: the eight neighbour bitboards of a word are summed with
+ * bitwise half and full adders, and the grid's B/S rule, compiled into a few bitwise terms, is
+ * applied to the resulting bit-sliced neighbour count. The row kernels themselves live in
+ * life_simd.c. Generations rules add a byte-per-cell pass over the kernel output that moves
+ * cells through their decay states, and Larger than Life rules replace the kernels with
+ * summed-area tables (see life_ltl.c).
+ */
+
+#include "life_engine.h" // for grid declarations
+#include "life_kernel.h" // for row kernels
+#include "thread_pool.h" // for multithreaded stepping
+#include "hashlife.h" // for the HashLife engine
+#include "sparse_universe.h" // for the sparse-universe engine
+#include "life_lut.h" // for the lookup-table engine
+#include "life_ltl.h" // for Larger than Life rules
+#include "life_temporal.h" // for the temporally blocked engine
+#include "life_cycle.h" // for cycle detection
+#include <SDL3/SDL.h> // for SDL memory functions
+#include <ctype.h>
+#include <string.h>
+#ifdef __linux__
+#include <sys/mman.h> // for madvise
+#endif
+
+// Grids smaller than this many words are stepped on the calling thread only, since waking the
+// workers would cost more than the generation itself
+#define LIFE_PARALLEL_MIN_WORDS 4096
+
+// Cell buffers at least this large are aligned to and backed by transparent huge pages where the
+// OS supports them, sparing the TLB misses of walking a big grid in 4 KiB pages
+#define LIFE_HUGE_PAGE_SIZE ((size_t) 2 << 20)
+
+/* --------------------------------------------------------------------------------------------
+ * Kernel Selection
+ * -------------------------------------------------------------------------------------------- */
+
+static const struct LifeKernelInfo *active_kernel = NULL; // Row kernel used by life_grid_step()
+
+/**
+ * @brief Picks the fastest row kernel supported by the running CPU.
+ *
+ * Called automatically by life_grid_init() the first time a grid is created.
+ */
+
+static void life_select_kernel(void) {
+    for (int i = life_kernel_count - 1; i >= 0; i--) {
+        if (life_kernels[i].supported()) {
+            active_kernel = &life_kernels[i];
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Returns the row kernel currently used for stepping.
+ */
+
+LifeRowKernel life_grid_kernel(void) {
+    if (!active_kernel) life_select_kernel();
+    return active_kernel->kernel;
+}
+
+/**
+ * @brief Returns the name of the row kernel currently used for stepping.
+ */
+
+const char *life_engine_kernel_name(void) {
+    if (!active_kernel) life_select_kernel();
+    return active_kernel->name;
+}
+
+/**
+ * @brief Forces a specific row kernel, e.g. to compare kernels against each other.
+ * @param name Kernel name ("scalar", "sse2", "avx2" or "avx512").
+ * @return true if the kernel exists and the CPU supports it, false otherwise.
+ */
+
+bool life_engine_set_kernel(const char *name) {
+    for (int i = 0; i < life_kernel_count; i++) {
+        if (strcmp(life_kernels[i].name, name) == 0) {
+            if (!life_kernels[i].supported()) {
+                SDL_SetError("Kernel '%s' is not supported by this CPU", name);
+                return false;
+            }
+            active_kernel = &life_kernels[i];
+            return true;
+        }
+    }
+    SDL_SetError("Unknown kernel '%s'", name);
+    return false;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Engine Selection
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Advances the grid one generation at a time with the bit-packed kernels.
+ */
+
+static void life_bitwise_advance(struct LifeGrid *g, uint64_t generations) {
+    for (uint64_t i = 0; i < generations; i++) {
+        life_grid_step(g);
+    }
+}
+
+const struct LifeEngine life_engines[] = {
+    {"bitwise", life_bitwise_advance, NULL, NULL, NULL, true, false},
+    {"lut", life_lut_advance, NULL, NULL, NULL, false, false},
+    {"temporal", life_temporal_advance, life_temporal_reset, NULL, NULL, false, false},
+    {"hashlife", hashlife_advance, hashlife_reset, hashlife_set_cell, hashlife_visit_cells, false,
+     true},
+    {"sparse", sparse_advance, sparse_reset, sparse_set_cell, sparse_visit_cells, false, false},
+};
+
+const int life_engine_count = sizeof(life_engines) / sizeof(life_engines[0]);
+
+static const struct LifeEngine *active_engine = &life_engines[0]; // Engine used for stepping
+
+/**
+ * @brief Returns the engine currently used by life_engine_advance().
+ */
+
+const struct LifeEngine *life_engine_current(void) {
+    return active_engine;
+}
+
+/**
+ * @brief Returns the engine that actually steps the grid: the current one, or the bitwise
+ *        engine standing in for it under a rule it does not support.
+ */
+
+const struct LifeEngine *life_engine_for_grid(const struct LifeGrid *g) {
+    if ((g->states || g->rule.range) && !active_engine->extended_rules) return &life_engines[0];
+    return active_engine;
+}
+
+/**
+ * @brief Lists every live cell of the plane of an unbounded engine, including those outside
+ *        the grid window. Edits of the grid are merged into the plane first.
+ * @param g Grid forming the visible window.
+ * @param visit Called once per live cell, in no particular order.
+ * @param ctx Passed on to `visit`.
+ * @return true if the cells were listed, false if the grid is stepped by a bounded engine.
+ */
+
+bool life_engine_visit_cells(struct LifeGrid *g, LifeCellVisitor visit, void *ctx) {
+    const struct LifeEngine *engine = life_engine_for_grid(g);
+    if (!engine->visit_cells) return false;
+    engine->advance(g, 0);
+    engine->visit_cells(visit, ctx);
+    return true;
+}
+
+/**
+ * @brief Switches to the named engine, discarding the private state of the previous one.
+ * @param name Engine name ("bitwise", "lut", "temporal", "hashlife" or "sparse").
+ * @return true if the engine exists, false otherwise.
+ */
+
+bool life_engine_select(const char *name) {
+    for (int i = 0; i < life_engine_count; i++) {
+        if (strcmp(life_engines[i].name, name) == 0) {
+            if (active_engine->reset) active_engine->reset();
+            active_engine = &life_engines[i];
+            return true;
+        }
+    }
+    SDL_SetError("Unknown engine '%s'", name);
+    return false;
+}
+
+/**
+ * @brief Advances the grid by the given number of generations with the selected engine, or with
+ *        the bitwise engine if the selected one does not support the grid's rule.
+ *
+ * While cycles are detected (see life_grid_detect_cycles()), generations are computed one at a
+ * time and hashed until the grid is proven to cycle; from then on whole periods are skipped, so
+ * any number of generations costs less than one period. Unbounded engines are never watched,
+ * since patterns that leave the grid can still change.
+ *
+ * @param g Grid to advance.
+ * @param generations Number of generations to advance.
+ */
+
+void life_engine_advance(struct LifeGrid *g, uint64_t generations) {
+    const struct LifeEngine *engine = life_engine_for_grid(g);
+
+    if (g->cycle.tile_hashes && !engine->set_cell) {
+        while (generations > 0 && !life_grid_cycle_period(g)) {
+            engine->advance(g, 1);
+            g->generation++;
+            generations--;
+            life_cycle_observe(g);
+        }
+        uint64_t period = life_grid_cycle_period(g);
+        if (period && generations >= period) {
+            uint64_t skipped = generations - generations % period;
+            g->generation += skipped;
+            generations -= skipped;
+            // The last generation computed is no longer the one before the current generation
+            if (!generations) g->changes.valid = false;
+        }
+    }
+    if (generations) engine->advance(g, generations);
+    g->generation += generations;
+}
+
+/**
+ * @brief Sets a cell anywhere on the plane, e.g. while loading a pattern larger than the grid.
+ *
+ * Cells inside the grid are set through the grid. Cells outside it are handed to the engine if
+ * it is unbounded and dropped otherwise.
+ *
+ * @param g Grid forming the visible window (cell (0, 0) of the plane is its top-left corner).
+ * @param x X-coordinate of the cell.
+ * @param y Y-coordinate of the cell.
+ * @param alive New state of the cell.
+ * @return true if the cell was stored, false if it fell outside a bounded grid.
+ */
+
+bool life_engine_place(struct LifeGrid *g, int64_t x, int64_t y, bool alive) {
+    if (x >= 0 && y >= 0 && x < g->width && y < g->height) {
+        life_grid_set(g, (int) x, (int) y, alive);
+        return true;
+    }
+    if (!active_engine->set_cell) return false;
+    active_engine->set_cell(x, y, alive);
+    return true;
+}
+
+/**
+ * @brief Kills every cell, including those an unbounded engine keeps outside the grid.
+ * @param g Grid to clear.
+ */
+
+void life_engine_clear(struct LifeGrid *g) {
+    life_grid_clear(g);
+    if (active_engine->reset) active_engine->reset();
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Grid Storage
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Allocates a zeroed cell buffer whose rows start on cache line boundaries.
+ * @param bytes Size of the buffer.
+ * @return The buffer, to be released with SDL_aligned_free(), or NULL on failure.
+ */
+
+static uint64_t *life_alloc_cells(size_t bytes) {
+    size_t align = LIFE_ROW_ALIGN;
+#ifdef __linux__
+    if (bytes >= LIFE_HUGE_PAGE_SIZE) {
+        align = LIFE_HUGE_PAGE_SIZE;
+        bytes = (bytes + LIFE_HUGE_PAGE_SIZE - 1) / LIFE_HUGE_PAGE_SIZE * LIFE_HUGE_PAGE_SIZE;
+    }
+#endif
+    uint64_t *cells = SDL_aligned_alloc(align, bytes);
+    if (!cells) return NULL;
+#ifdef __linux__
+    // Only a hint: the kernel may still fall back to normal pages
+    if (align == LIFE_HUGE_PAGE_SIZE) madvise(cells, bytes, MADV_HUGEPAGE);
+#endif
+    memset(cells, 0, bytes);
+    return cells;
+}
+
+/**
+ * @brief Allocates an all-dead grid of the given size.
+ * @param g Grid to initialize.
+ * @param width Number of cells horizontally.
+ * @param height Number of cells vertically.
+ * @return true if the grid was allocated, false otherwise.
+ */
+
+bool life_grid_init(struct LifeGrid *g, int width, int height) {
+    memset(g, 0, sizeof(*g));
+    if (!active_kernel) life_select_kernel();
+    if (width <= 0 || height <= 0 || width > LIFE_MAX_DIMENSION || height > LIFE_MAX_DIMENSION) {
+        SDL_SetError("Invalid grid size %dx%d", width, height);
+        return false;
+    }
+
+    g->width = width;
+    g->height = height;
+    g->words = (width + LIFE_WORD_BITS - 1) / LIFE_WORD_BITS;
+    // Room for the halo words, rounded up to whole cache lines
+    g->stride = (LIFE_ROW_OFFSET + g->words + 1 + LIFE_ROW_OFFSET - 1) / LIFE_ROW_OFFSET * LIFE_ROW_OFFSET;
+    // Keep only the bits of the last word that map to real cells
+    int tail = width % LIFE_WORD_BITS;
+    g->last_mask = tail ? (((uint64_t) 1 << tail) - 1) : ~(uint64_t) 0;
+    g->topology = LIFE_TOPOLOGY_DEAD;
+    g->rule = LIFE_RULE_CONWAY;
+    life_rule_compile(&g->rule, &g->program);
+
+    // One halo row above and below the grid
+    size_t bytes = (size_t) g->stride * (height + 2) * sizeof(uint64_t);
+    g->front = life_alloc_cells(bytes);
+    g->back = life_alloc_cells(bytes);
+    g->zero = SDL_calloc(g->stride, sizeof(uint64_t));
+
+    // An all-dead grid has no changes, so every tile starts asleep
+    g->tile_rows = (height + LIFE_TILE_ROWS - 1) / LIFE_TILE_ROWS;
+    size_t tiles = (size_t) g->words * g->tile_rows;
+    g->tile_changed = SDL_calloc(tiles, 1);
+    g->tile_next_changed = SDL_calloc(tiles, 1);
+    g->tile_active = SDL_calloc(tiles, 1);
+    g->tile_row_active = SDL_calloc(g->tile_rows, 1);
+    if (!g->front || !g->back || !g->zero || !g->tile_changed || !g->tile_next_changed ||
+        !g->tile_active || !g->tile_row_active) {
+        life_grid_free(g);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Frees the buffers owned by a grid.
+ * @param g Grid to free.
+ */
+
+void life_grid_free(struct LifeGrid *g) {
+    SDL_aligned_free(g->front);
+    SDL_aligned_free(g->back);
+    SDL_aligned_free(g->states);
+    SDL_free(g->zero);
+    SDL_free(g->tile_changed);
+    SDL_free(g->tile_next_changed);
+    SDL_free(g->tile_active);
+    SDL_free(g->tile_row_active);
+    life_grid_track_changes(g, false);
+    life_grid_detect_cycles(g, false);
+    memset(g, 0, sizeof(*g));
+}
+
+/**
+ * @brief Counts the live cells of the grid (state 1 under a Generations rule).
+ */
+
+uint64_t life_grid_population(const struct LifeGrid *g) {
+    uint64_t population = 0;
+    for (int y = 0; y < g->height; y++) {
+        const uint64_t *row = life_grid_row(g, y);
+        for (int i = 0; i < g->words - 1; i++) population += (uint64_t) life_popcount(row[i]);
+        // The padding bits may hold the east halo
+        population += (uint64_t) life_popcount(row[g->words - 1] & g->last_mask);
+    }
+    return population;
+}
+
+/**
+ * @brief Kills every cell in the grid.
+ * @param g Grid to clear.
+ */
+
+void life_grid_clear(struct LifeGrid *g) {
+    memset(life_grid_front(g), 0, (size_t) g->stride * (g->height + 2) * sizeof(uint64_t));
+    if (g->states) memset(g->states, 0, (size_t) g->height * g->words * LIFE_WORD_BITS);
+    life_grid_mark_all(g);
+}
+
+/**
+ * @brief Marks every tile as changed, e.g. after writing rows directly instead of through
+ *        life_grid_set().
+ * @param g Grid whose tiles are woken up.
+ */
+
+void life_grid_mark_all(struct LifeGrid *g) {
+    memset(g->tile_changed, 1, (size_t) g->words * g->tile_rows);
+    g->changes.valid = false;
+    g->edits++;
+}
+
+/**
+ * @brief Starts or stops recording the births and deaths of every generation (see struct
+ *        LifeChangeSet). The set becomes valid with the next generation computed.
+ * @param g Grid whose changes are recorded.
+ * @param enable True to record changes, false to stop and free the change set.
+ * @return true on success, false if the change set could not be allocated.
+ */
+
+bool life_grid_track_changes(struct LifeGrid *g, bool enable) {
+    struct LifeChangeSet *changes = &g->changes;
+    if (!enable || !changes->births) {
+        SDL_free(changes->births);
+        SDL_free(changes->deaths);
+        SDL_free(changes->tile_row_births);
+        SDL_free(changes->tile_row_deaths);
+        memset(changes, 0, sizeof(*changes));
+    }
+    if (!enable || changes->births) return true;
+
+    size_t words = (size_t) g->words * g->height;
+    changes->births = SDL_calloc(words, sizeof(uint64_t));
+    changes->deaths = SDL_calloc(words, sizeof(uint64_t));
+    changes->tile_row_births = SDL_calloc(g->tile_rows, sizeof(uint32_t));
+    changes->tile_row_deaths = SDL_calloc(g->tile_rows, sizeof(uint32_t));
+    if (!changes->births || !changes->deaths || !changes->tile_row_births ||
+        !changes->tile_row_deaths) {
+        life_grid_track_changes(g, false);
+        return false;
+    }
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Topology
+ * -------------------------------------------------------------------------------------------- */
+
+const char *const life_topology_names[LIFE_TOPOLOGY_COUNT] = {"dead", "torus", "klein"};
+
+/**
+ * @brief Changes how the grid edges connect.
+ * @param g Grid to change.
+ * @param topology New topology.
+ */
+
+void life_grid_set_topology(struct LifeGrid *g, enum LifeTopology topology) {
+    g->topology = topology;
+    // Edge cells see different neighbours now
+    life_grid_mark_all(g);
+}
+
+/**
+ * @brief Looks up a topology by name.
+ * @param name Topology name ("dead", "torus" or "klein").
+ * @param topology Receives the topology.
+ * @return true if the name is known, false otherwise.
+ */
+
+bool life_topology_parse(const char *name, enum LifeTopology *topology) {
+    for (int i = 0; i < LIFE_TOPOLOGY_COUNT; i++) {
+        if (strcmp(life_topology_names[i], name) == 0) {
+            *topology = (enum LifeTopology) i;
+            return true;
+        }
+    }
+    SDL_SetError("Unknown topology '%s'", name);
+    return false;
+}
+
+/**
+ * @brief Reverses the order of the bits in a word.
+ */
+
+static uint64_t life_reverse_bits(uint64_t v) {
+    v = ((v >> 1) & 0x5555555555555555ull) | ((v & 0x5555555555555555ull) << 1);
+    v = ((v >> 2) & 0x3333333333333333ull) | ((v & 0x3333333333333333ull) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((v & 0x0F0F0F0F0F0F0F0Full) << 4);
+    v = ((v >> 8) & 0x00FF00FF00FF00FFull) | ((v & 0x00FF00FF00FF00FFull) << 8);
+    v = ((v >> 16) & 0x0000FFFF0000FFFFull) | ((v & 0x0000FFFF0000FFFFull) << 16);
+    return (v >> 32) | (v << 32);
+}
+
+/**
+ * @brief Writes the row `src` mirrored left to right into `dst`, which must be another row.
+ */
+
+void life_mirror_row(const struct LifeGrid *g, const uint64_t *src, uint64_t *dst) {
+    // Reversing all `words` words mirrors the padded row; shifting by the padding realigns it
+    int words = g->words, shift = words * LIFE_WORD_BITS - g->width;
+    for (int i = 0; i < words; i++) {
+        uint64_t lo = life_reverse_bits(src[words - 1 - i]);
+        uint64_t hi = i + 1 < words ? life_reverse_bits(src[words - 2 - i]) : 0;
+        dst[i] = shift ? (lo >> shift) | (hi << (LIFE_WORD_BITS - shift)) : lo;
+    }
+}
+
+/**
+ * @brief Fills the halo of the current generation from the grid edges according to the
+ *        topology. Called before every generation.
+ * @param g Grid whose halo is refreshed.
+ */
+
+void life_grid_refresh_halo(struct LifeGrid *g) {
+    int words = g->words;
+    uint64_t *top = life_grid_row(g, -1), *bottom = life_grid_row(g, g->height);
+    const uint64_t *first = life_grid_row(g, 0), *last = life_grid_row(g, g->height - 1);
+
+    // Halo rows first, so the halo words below also cover the corners
+    switch (g->topology) {
+    case LIFE_TOPOLOGY_TORUS:
+        memcpy(top, last, (size_t) words * sizeof(uint64_t));
+        memcpy(bottom, first, (size_t) words * sizeof(uint64_t));
+        break;
+    case LIFE_TOPOLOGY_KLEIN:
+        life_mirror_row(g, last, top);
+        life_mirror_row(g, first, bottom);
+        break;
+    default:
+        memset(top, 0, (size_t) words * sizeof(uint64_t));
+        memset(bottom, 0, (size_t) words * sizeof(uint64_t));
+        break;
+    }
+
+    for (int y = -1; y <= g->height; y++) life_grid_refresh_row_halo(g, life_grid_row(g, y));
+}
+
+/**
+ * @brief Fills the halo words (and the padding bits) of one row from the row itself, since the
+ *        left and right edges of every topology either wrap around or are dead.
+ * @param g Grid the row belongs to.
+ * @param row First word of the row; need not be stored in the grid.
+ */
+
+void life_grid_refresh_row_halo(const struct LifeGrid *g, uint64_t *row) {
+    int words = g->words, tail = g->width % LIFE_WORD_BITS;
+    if (g->topology == LIFE_TOPOLOGY_DEAD) {
+        row[-1] = 0;
+        row[words] = 0;
+        row[words - 1] &= g->last_mask;
+        return;
+    }
+    // West of cell 0 is the last cell; east of the last cell is cell 0, which lands in the
+    // first padding bit unless the row fills its last word exactly
+    row[-1] = ((row[words - 1] >> ((g->width - 1) % LIFE_WORD_BITS)) & 1) << 63;
+    if (tail) {
+        row[words - 1] = (row[words - 1] & g->last_mask) | ((row[0] & 1) << tail);
+        row[words] = 0;
+    } else {
+        row[words] = row[0] & 1;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Rules
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Changes the rule the grid evolves under.
+ *
+ * Switching to a Generations rule allocates the state plane, with every live cell in state 1,
+ * and a Larger than Life rule reserves the tables of the calling thread.
+ * Switching back to a Life-like rule frees it, so cells in a decay state die; so do cells in
+ * states the new rule does not have.
+ *
+ * @param g Grid to change.
+ * @param rule New rule.
+ * @return true if the rule was applied, false if the state plane could not be allocated.
+ */
+
+bool life_grid_set_rule(struct LifeGrid *g, const struct LifeRule *rule) {
+    if (rule->range) {
+        struct LifeGrid sized = *g;
+        sized.rule = *rule;
+        if (!life_ltl_reserve(&sized, 1)) {
+            SDL_SetError("Out of memory for the range-%d neighbourhood tables", rule->range);
+            return false;
+        }
+    }
+    size_t cells = (size_t) g->height * g->words * LIFE_WORD_BITS;
+    if (rule->states > 2 && !g->states) {
+        g->states = (uint8_t *) life_alloc_cells(cells);
+        if (!g->states) {
+            SDL_SetError("Out of memory for the %d-state plane", rule->states);
+            return false;
+        }
+        for (int y = 0; y < g->height; y++) {
+            uint8_t *states = life_grid_state_row(g, y);
+            for (int x = 0; x < g->width; x++) states[x] = life_grid_get(g, x, y);
+        }
+    } else if (rule->states > 2) {
+        for (size_t i = 0; i < cells; i++) {
+            if (g->states[i] >= rule->states) g->states[i] = 0;
+        }
+    } else if (g->states) {
+        SDL_aligned_free(g->states);
+        g->states = NULL;
+    }
+    g->rule = *rule;
+    life_rule_compile(rule, &g->program);
+    // A stable region under the old rule need not be stable under the new one
+    life_grid_mark_all(g);
+    return true;
+}
+
+/**
+ * @brief Adds the digits at `p` to a set of neighbour counts.
+ * @return Pointer to the first character that is not a digit from 0 to 8.
+ */
+
+static const char *life_rule_parse_counts(const char *p, uint16_t *counts) {
+    while (*p >= '0' && *p <= '8') *counts |= 1 << (*p++ - '0');
+    return p;
+}
+
+/**
+ * @brief Parses the number of states of a Generations rule, if `p` has one.
+ * @return Pointer past the number, or `p` itself if it does not start with a valid one.
+ */
+
+static const char *life_rule_parse_states(const char *p, uint8_t *states) {
+    const char *q = p;
+    int value = 0;
+    while (isdigit((unsigned char) *q) && value <= 255) value = value * 10 + (*q++ - '0');
+    if (q == p || value < 2 || value > 255) return p;
+    *states = (uint8_t) value;
+    return q;
+}
+
+/**
+ * @brief Parses a decimal number of at most five digits.
+ * @return Pointer past the number, or `p` itself if it does not start with one.
+ */
+
+static const char *life_rule_parse_number(const char *p, int *value) {
+    const char *q = p;
+    *value = 0;
+    while (isdigit((unsigned char) *q) && q - p < 5) *value = *value * 10 + (*q++ - '0');
+    return isdigit((unsigned char) *q) ? p : q;
+}
+
+/**
+ * @brief Parses a count interval such as "34..58", or a single count standing for itself.
+ * @return Pointer past the interval, or `p` itself if it is not a valid one.
+ */
+
+static const char *life_rule_parse_interval(const char *p, uint16_t *min, uint16_t *max) {
+    int low, high;
+    const char *q = life_rule_parse_number(p, &low);
+    if (q == p) return p;
+    high = low;
+    if (q[0] == '.' && q[1] == '.') {
+        const char *end = life_rule_parse_number(q + 2, &high);
+        if (end == q + 2) return p;
+        q = end;
+    }
+    if (low > high || high > UINT16_MAX) return p;
+    *min = (uint16_t) low;
+    *max = (uint16_t) high;
+    return q;
+}
+
+/**
+ * @brief Parses a Larger than Life rule in the comma-separated notation used by Golly, e.g.
+ *        "R5,C0,M1,S34..58,B34..45,NM".
+ *
+ * R is the range, C the number of states (0 and 2 both mean two), M whether cells count
+ * themselves, S and B the survival and birth intervals and N the neighbourhood: M for Moore
+ * (square) or N for von Neumann (diamond). R, S and B are required.
+ */
+
+static bool life_rule_parse_ltl(const char *text, struct LifeRule *rule) {
+    struct LifeRule parsed = {.states = 2};
+    bool seen_survival = false, seen_birth = false, valid = true;
+    const char *p = text;
+    while (isspace((unsigned char) *p)) p++;
+
+    while (valid && *p && !isspace((unsigned char) *p)) {
+        char key = (char) toupper((unsigned char) *p++);
+        const char *start = p;
+        int value;
+        switch (key) {
+        case 'R':
+            p = life_rule_parse_number(p, &value);
+            valid = p != start && value >= 1 && value <= LIFE_MAX_RANGE;
+            parsed.range = (uint8_t) value;
+            break;
+        case 'C':
+            p = life_rule_parse_number(p, &value);
+            valid = p != start && (value == 0 || (value >= 2 && value <= 255));
+            parsed.states = (uint8_t) (value ? value : 2);
+            break;
+        case 'M':
+            valid = *p == '0' || *p == '1';
+            if (valid) parsed.middle = *p++ == '1';
+            break;
+        case 'S':
+            p = life_rule_parse_interval(p, &parsed.survival_min, &parsed.survival_max);
+            valid = seen_survival = p != start;
+            break;
+        case 'B':
+            p = life_rule_parse_interval(p, &parsed.birth_min, &parsed.birth_max);
+            valid = seen_birth = p != start;
+            break;
+        case 'N':
+            valid = toupper((unsigned char) *p) == 'M' || toupper((unsigned char) *p) == 'N';
+            if (valid) parsed.von_neumann = toupper((unsigned char) *p++) == 'N';
+            break;
+        default:
+            valid = false;
+            break;
+        }
+        if (*p == ',') p++;
+    }
+    while (isspace((unsigned char) *p)) p++;
+
+    if (!valid || *p || !parsed.range || !seen_survival || !seen_birth) {
+        SDL_SetError("Invalid rule '%s'", text);
+        return false;
+    }
+    if (parsed.birth_min == 0) {
+        SDL_SetError("Rules with birth on 0 neighbours (B0) are not supported");
+        return false;
+    }
+    *rule = parsed;
+    return true;
+}
+
+/**
+ * @brief Parses a rule string.
+ *
+ * Accepts B/S notation in either order and any case ("B36/S23", "s23/b36", "B3S23") as well as
+ * the older survival/birth notation ("23/36"). Generations rules add their number of states as
+ * a third part ("B2/S/C3", "B345/S2/C4") or, in survival/birth notation, as a bare third number
+ * ("/2/3", "345/2/4"). Larger than Life rules use the notation of life_rule_parse_ltl(). Rules
+ * with B0 are rejected: a dead plane would come alive everywhere at once, which neither the
+ * skipping of stable tiles nor the unbounded engines can represent.
+ *
+ * @param text Rule string.
+ * @param rule Receives the rule.
+ * @return true if the rule is valid, false otherwise.
+ */
+
+bool life_rule_parse(const char *text, struct LifeRule *rule) {
+    struct LifeRule parsed = {.states = 2};
+    const char *p = text;
+    while (isspace((unsigned char) *p)) p++;
+    if ((*p == 'R' || *p == 'r') && isdigit((unsigned char) p[1])) {
+        return life_rule_parse_ltl(text, rule);
+    }
+
+    if (isdigit((unsigned char) *p) || *p == '/') {
+        p = life_rule_parse_counts(p, &parsed.survival);
+        if (*p == '/') p = life_rule_parse_counts(p + 1, &parsed.birth);
+        if (*p == '/') {
+            const char *states = p + 1;
+            p = life_rule_parse_states(states, &parsed.states);
+            if (p == states) p = text; // Force the error below
+        }
+    } else {
+        bool seen_birth = false, seen_survival = false;
+        while (*p == 'B' || *p == 'b' || *p == 'S' || *p == 's') {
+            bool birth = *p == 'B' || *p == 'b';
+            if (birth ? seen_birth : seen_survival) break;
+            *(birth ? &seen_birth : &seen_survival) = true;
+            p = life_rule_parse_counts(p + 1, birth ? &parsed.birth : &parsed.survival);
+            if (*p == '/') p++;
+        }
+        if (*p == 'C' || *p == 'c') {
+            const char *states = p + 1;
+            p = life_rule_parse_states(states, &parsed.states);
+            if (p == states) p = text;
+        }
+        if (!seen_birth || !seen_survival) p = text; // Force the error below
+    }
+
+    while (isspace((unsigned char) *p)) p++;
+    if (*p || p == text) {
+        SDL_SetError("Invalid rule '%s'", text);
+        return false;
+    }
+    if (parsed.birth & 1) {
+        SDL_SetError("Rules with birth on 0 neighbours (B0) are not supported");
+        return false;
+    }
+    *rule = parsed;
+    return true;
+}
+
+/**
+ * @brief Writes a rule in B/S notation, e.g. "B36/S23", followed by the number of states for a
+ *        Generations rule, e.g. "B2/S/C3". Larger than Life rules are written in the notation
+ *        life_rule_parse_ltl() reads.
+ * @param rule Rule to format.
+ * @param text Destination buffer (LIFE_RULE_TEXT_SIZE bytes are always enough).
+ * @param size Size of the destination buffer.
+ */
+
+void life_rule_format(const struct LifeRule *rule, char *text, size_t size) {
+    char buffer[LIFE_RULE_TEXT_SIZE], *p = buffer;
+    if (rule->range) {
+        SDL_snprintf(text, size, "R%d,C%d,M%d,S%d..%d,B%d..%d,N%c", rule->range,
+                     rule->states > 2 ? rule->states : 0, rule->middle, rule->survival_min,
+                     rule->survival_max, rule->birth_min, rule->birth_max,
+                     rule->von_neumann ? 'N' : 'M');
+        return;
+    }
+    *p++ = 'B';
+    for (int n = 0; n <= 8; n++) if (rule->birth & (1 << n)) *p++ = (char) ('0' + n);
+    *p++ = '/';
+    *p++ = 'S';
+    for (int n = 0; n <= 8; n++) if (rule->survival & (1 << n)) *p++ = (char) ('0' + n);
+    *p = '\0';
+    if (rule->states > 2) {
+        SDL_snprintf(p, sizeof(buffer) - (size_t) (p - buffer), "/C%d", rule->states);
+    }
+    SDL_strlcpy(text, buffer, size);
+}
+
+/**
+ * @brief Compiles a rule into one bitwise term per neighbour count that yields a live cell.
+ * @param rule Rule to compile.
+ * @param program Receives the compiled rule.
+ */
+
+void life_rule_compile(const struct LifeRule *rule, struct LifeRuleProgram *program) {
+    memset(program, 0, sizeof(*program));
+    program->conway = rule->birth == LIFE_RULE_CONWAY.birth &&
+                      rule->survival == LIFE_RULE_CONWAY.survival;
+    for (int n = 0; n <= 8; n++) {
+        bool born = (rule->birth >> n) & 1, survives = (rule->survival >> n) & 1;
+        if (!born && !survives) continue;
+        struct LifeRuleTerm *term = &program->terms[program->term_count++];
+        for (int k = 0; k < 4; k++) term->count_flip[k] = ((n >> k) & 1) ? 0 : ~(uint64_t) 0;
+        term->born = born ? ~(uint64_t) 0 : 0;
+        term->survives = survives ? ~(uint64_t) 0 : 0;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Worker Threads
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Sets how many threads share the work of each generation.
+ * @param threads Number of threads including the caller; 0 uses one per logical CPU core.
+ * @return true if the worker threads were started, false otherwise.
+ */
+
+bool life_engine_set_threads(int threads) {
+    return thread_pool_init(threads);
+}
+
+/**
+ * @brief Stops the worker threads started by life_engine_set_threads().
+ */
+
+void life_engine_shutdown(void) {
+    thread_pool_shutdown();
+    life_ltl_free();
+    if (active_engine->reset) active_engine->reset();
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Next Generation
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Decides which tiles must be recomputed: those that changed in the last generation and
+ *        their eight neighbours. A cell can only change if something in its neighbourhood did,
+ *        and that neighbourhood never reaches beyond the adjacent tiles (across the wrapped edges
+ *        too, unless the border is dead): LIFE_MAX_RANGE is no larger than a tile.
+ */
+
+static void life_update_active_tiles(struct LifeGrid *g) {
+    int tx_count = g->words, ty_count = g->tile_rows;
+    bool wrap_x = g->topology != LIFE_TOPOLOGY_DEAD, wrap_y = g->topology == LIFE_TOPOLOGY_TORUS;
+
+    // The Klein bottle glues the top and bottom edges mirrored, which does not map tile columns
+    // onto each other, so a change anywhere along one of them wakes the whole opposite edge
+    uint8_t top_changed = 0, bottom_changed = 0;
+    if (g->topology == LIFE_TOPOLOGY_KLEIN) {
+        for (int tx = 0; tx < tx_count; tx++) {
+            top_changed |= g->tile_changed[tx];
+            bottom_changed |= g->tile_changed[(size_t) (ty_count - 1) * tx_count + tx];
+        }
+    }
+
+    for (int ty = 0; ty < ty_count; ty++) {
+        bool row_active = false;
+        for (int tx = 0; tx < tx_count; tx++) {
+            uint8_t active = 0;
+            for (int dy = -1; dy <= 1; dy++) {
+                int y = ty + dy;
+                if (y < 0 || y >= ty_count) {
+                    if (!wrap_y) continue;
+                    y = (y + ty_count) % ty_count;
+                }
+                const uint8_t *changed = g->tile_changed + (size_t) y * tx_count;
+                for (int dx = -1; dx <= 1; dx++) {
+                    int x = tx + dx;
+                    if (x < 0 || x >= tx_count) {
+                        if (!wrap_x) continue;
+                        x = (x + tx_count) % tx_count;
+                    }
+                    active |= changed[x];
+                }
+            }
+            if (ty == 0) active |= bottom_changed;
+            if (ty == ty_count - 1) active |= top_changed;
+            g->tile_active[(size_t) ty * tx_count + tx] = active;
+            row_active |= active;
+        }
+        g->tile_row_active[ty] = row_active;
+    }
+}
+
+/**
+ * @brief Applies a Generations rule to words [w0, w1) of a row, given the kernel's output.
+ *
+ * The kernel (or the Larger than Life step) computes the row as if every cell were dead or
+ * alive, which already gives the right answer for cells in state 0 and 1: a set bit means born
+ * or survived. This pass moves the rest along and works on 64 states per word with byte
+ * operations the compiler vectorizes; the bits are spread to bytes and gathered back eight at a
+ * time with multiplications.
+ *
+ * @param states State row, updated in place.
+ * @param out Kernel output, replaced by the live cells of the new states.
+ * @param last Highest state of the rule; cells in it die next.
+ * @param changed Change flags of the row's tiles, set where any state changed.
+ */
+
+void life_age_cells(uint8_t *states, uint64_t *out, int w0, int w1, uint8_t last,
+                    uint8_t *changed) {
+    for (int i = w0; i < w1; i++) {
+        uint8_t *s = states + (size_t) i * LIFE_WORD_BITS;
+        uint8_t live[LIFE_WORD_BITS], alive[LIFE_WORD_BITS];
+        for (int k = 0; k < 8; k++) {
+            // Byte j of the product holds bit j of the octet in its own bit position j
+            uint64_t octet = (out[i] >> (8 * k)) & 0xFF;
+            uint64_t bytes = (octet * 0x0101010101010101ull) & 0x8040201008040201ull;
+            bytes = ((bytes + 0x7F7F7F7F7F7F7F7Full) >> 7) & 0x0101010101010101ull;
+            memcpy(live + 8 * k, &bytes, 8);
+        }
+
+        uint8_t diff = 0;
+        for (int b = 0; b < LIFE_WORD_BITS; b++) {
+            uint8_t old = s[b];
+            // Live cells that fail to survive, like decaying ones, advance one state
+            uint8_t aged = old == last ? 0 : (uint8_t) (old + 1);
+            uint8_t next = old == 0 ? live[b] : ((old == 1) & live[b]) ? 1 : aged;
+            diff |= next ^ old;
+            alive[b] = next == 1;
+            s[b] = next;
+        }
+
+        uint64_t word = 0;
+        for (int k = 0; k < 8; k++) {
+            // Distinct shifts for every byte, so the product gathers the eight bits without carries
+            uint64_t bytes;
+            memcpy(&bytes, alive + 8 * k, 8);
+            word |= ((bytes * 0x0102040810204080ull) >> 56) << (8 * k);
+        }
+        out[i] = word;
+        changed[i] |= diff != 0;
+    }
+}
+
+/**
+ * @brief Computes the active tiles in tile rows [ty0, ty1) into the back buffer and records
+ *        which of them actually changed.
+ *
+ * Runs of adjacent active tiles in a row are handed to the kernel as one word range so the
+ * SIMD kernels still see long stretches of words.
+ */
+
+static void life_step_tiles(struct LifeGrid *g, LifeRowKernel kernel, int ty0, int ty1) {
+    int words = g->words;
+    for (int ty = ty0; ty < ty1; ty++) {
+        if (!g->tile_row_active[ty]) continue;
+        const uint8_t *active = g->tile_active + (size_t) ty * words;
+        uint8_t *changed = g->tile_next_changed + (size_t) ty * words;
+        int y_end = (ty + 1) * LIFE_TILE_ROWS < g->height ? (ty + 1) * LIFE_TILE_ROWS : g->height;
+
+        for (int y = ty * LIFE_TILE_ROWS; y < y_end; y++) {
+            // The halo rows stand in for the neighbours of the top and bottom rows
+            const uint64_t *above = life_grid_row(g, y - 1);
+            const uint64_t *row = life_grid_row(g, y);
+            const uint64_t *below = life_grid_row(g, y + 1);
+            uint64_t *out = life_grid_back_row(g, y);
+
+            int w0 = 0;
+            while (w0 < words) {
+                if (!active[w0]) {
+                    w0++;
+                    continue;
+                }
+                int w1 = w0 + 1;
+                while (w1 < words && active[w1]) w1++;
+
+                kernel(above, row, below, out, w0, w1, &g->program);
+                // Cells past the right edge never come alive, and the padding bits of the
+                // current generation may hold the east halo
+                if (w1 == words) out[words - 1] &= g->last_mask;
+                if (g->states) {
+                    life_age_cells(life_grid_state_row(g, y), out, w0, w1,
+                                   (uint8_t) (g->rule.states - 1), changed);
+                }
+                int end = w1;
+                if (w1 == words) {
+                    changed[words - 1] |= out[words - 1] != (row[words - 1] & g->last_mask);
+                    end = words - 1;
+                }
+                for (int i = w0; i < end; i++) changed[i] |= (out[i] != row[i]);
+                if (g->changes.births) {
+                    for (int i = w0; i < w1; i++) {
+                        uint64_t mask = i == words - 1 ? g->last_mask : ~(uint64_t) 0;
+                        life_record_changes(g, y, i, row[i] & mask, out[i]);
+                    }
+                }
+                w0 = w1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Thread pool job computing one horizontal band of tile rows.
+ */
+
+static void life_step_band(void *ctx, int index, int count) {
+    struct LifeGrid *g = ctx;
+    int ty0 = (int) ((long long) g->tile_rows * index / count);
+    int ty1 = (int) ((long long) g->tile_rows * (index + 1) / count);
+    if (g->rule.range) {
+        life_ltl_step_tiles(g, ty0, ty1, index);
+    } else {
+        life_step_tiles(g, active_kernel->kernel, ty0, ty1);
+    }
+}
+
+/**
+ * @brief Advances the grid by one generation according to its rule.
+ *
+ * The halo is refreshed first, so the kernels see the edges as the topology connects them
+ * without checking coordinates. Only active tiles are recomputed, each row of them by the
+ * selected row kernel (see life_simd.c), or from summed-area tables under a Larger than Life
+ * rule (see life_ltl.c). Large grids are split into one horizontal band of tile
+ * rows per worker thread; every band only reads the front buffer and writes its own rows of the
+ * back buffer, so no locking is needed beyond the pool's barrier.
+ *
+ * @param g Grid to advance.
+ */
+
+void life_grid_step(struct LifeGrid *g) {
+    life_grid_refresh_halo(g);
+    life_update_active_tiles(g);
+
+    // Larger than Life needs tables per worker; those of the calling thread were reserved by
+    // life_grid_set_rule(), so running out of memory for the others only costs parallelism
+    if ((size_t) g->words * g->height < LIFE_PARALLEL_MIN_WORDS || thread_pool_size() == 1 ||
+        (g->rule.range && !life_ltl_reserve(g, thread_pool_size()))) {
+        life_step_band(g, 0, 1);
+    } else {
+        thread_pool_run(life_step_band, g);
+    }
+    life_grid_swap(g);
+}
+
+/**
+ * @brief Makes the freshly computed back buffer the current generation.
+ *
+ * The change flags collected while computing it are swapped in at the same time: they decide
+ * which tiles wake up next generation, and they are exactly the tiles in which the two buffers
+ * now differ. The births and deaths counted per row of tiles are totalled for the change set.
+ *
+ * @param g Grid whose buffers are swapped.
+ */
+
+void life_grid_swap(struct LifeGrid *g) {
+    uint64_t *front = g->front;
+    g->front = g->back;
+    g->back = front;
+
+    uint8_t *changed = g->tile_changed;
+    g->tile_changed = g->tile_next_changed;
+    g->tile_next_changed = changed;
+    memset(g->tile_next_changed, 0, (size_t) g->words * g->tile_rows);
+
+    struct LifeChangeSet *changes = &g->changes;
+    if (changes->births) {
+        changes->birth_count = 0;
+        changes->death_count = 0;
+        for (int ty = 0; ty < g->tile_rows; ty++) {
+            changes->birth_count += changes->tile_row_births[ty];
+            changes->death_count += changes->tile_row_deaths[ty];
+        }
+        memset(changes->tile_row_births, 0, (size_t) g->tile_rows * sizeof(uint32_t));
+        memset(changes->tile_row_deaths, 0, (size_t) g->tile_rows * sizeof(uint32_t));
+        changes->valid = true;
+    }
+}
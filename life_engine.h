@@ -0,0 +1,377 @@
+/**
+ * @file life_engine.h
+ * @brief Declarations for the bit-packed Game of Life grid and its stepping engine.
+ *
+ * The grid stores one cell per bit in rows of 64-bit words, so a whole word of 64 cells is
+ * advanced to the next generation with a handful of bitwise full-adder operations instead of
+ * 64 separate neighbour counts.
+ */
+
+#ifndef LIFE_ENGINE_H
+#define LIFE_ENGINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LIFE_WORD_BITS 64 // Number of cells packed into one grid word
+#define LIFE_TILE_ROWS 32 // Height of an activity tile; tiles are one word (64 cells) wide
+#define LIFE_ROW_ALIGN 64 // Byte alignment of the first word of every row (one cache line)
+#define LIFE_ROW_OFFSET (LIFE_ROW_ALIGN / 8) // Words from the start of a stored row to word 0
+#define LIFE_MAX_DIMENSION (1 << 20) // Largest supported width or height in cells
+#define LIFE_MAX_RANGE LIFE_TILE_ROWS // Largest Larger than Life radius; tile skipping relies on it
+#define LIFE_CYCLE_HISTORY 1024 // Generations of hashes kept; longer periods go undetected
+
+/**
+ * @enum LifeTopology
+ * @brief How the edges of a bounded grid connect.
+ */
+
+enum LifeTopology {
+    LIFE_TOPOLOGY_DEAD, // Everything beyond the edges is permanently dead
+    LIFE_TOPOLOGY_TORUS, // Left/right and top/bottom edges wrap around
+    LIFE_TOPOLOGY_KLEIN, // Left/right edges wrap; top/bottom edges wrap mirrored left to right
+    LIFE_TOPOLOGY_COUNT // Number of topologies
+};
+
+/**
+ * @struct LifeRule
+ * @brief A Life-like, Generations or Larger than Life cellular automaton rule.
+ *
+ * Bit n of `birth` is set if a dead cell with n live neighbours comes alive, and bit n of
+ * `survival` if a live cell with n live neighbours stays alive. Conway's Life is B3/S23.
+ *
+ * Generations rules have more than two `states`. State 0 is dead and state 1 alive; only live
+ * cells count as neighbours. A live cell that does not survive enters state 2 instead of dying,
+ * then ages by one state per generation until it dies after state `states - 1`. Cells in those
+ * decay states cannot be born again. Brian's Brain is B2/S/C3.
+ *
+ * Larger than Life rules have a nonzero `range` and count the live cells within that many cells
+ * in either a square (Moore) or a diamond (von Neumann) neighbourhood, optionally including the
+ * cell itself. Births and survivals then use the count intervals instead of the bit sets, and
+ * any number of states works as for Generations rules. Bosco's Rule is R5,C0,M1,S34..58,B34..45,NM.
+ */
+
+struct LifeRule {
+    uint16_t birth; // Neighbour counts that bring a dead cell to life
+    uint16_t survival; // Neighbour counts that keep a live cell alive
+    uint8_t states; // Number of cell states: 2 for Life-like rules, more for Generations rules
+    uint8_t range; // Larger than Life radius (up to LIFE_MAX_RANGE), or 0 for the 3x3 neighbourhood
+    bool von_neumann; // Larger than Life: diamond instead of square neighbourhood
+    bool middle; // Larger than Life: each cell counts itself when alive
+    uint16_t birth_min, birth_max; // Larger than Life: counts that bring a dead cell to life
+    uint16_t survival_min, survival_max; // Larger than Life: counts that keep a live cell alive
+};
+
+#define LIFE_RULE_CONWAY /* B3/S23 */ \
+    ((struct LifeRule) {.birth = 1 << 3, .survival = (1 << 2) | (1 << 3), .states = 2})
+#define LIFE_RULE_TEXT_SIZE 48 // Buffer size for life_rule_format(), terminator included
+
+#define LIFE_RULE_MAX_TERMS 9 // One term per neighbour count from 0 to 8
+
+/**
+ * @struct LifeRuleTerm
+ * @brief Cells with one particular neighbour count, and what happens to them.
+ *
+ * `count_flip[k]` is all ones if bit k of the count is 0, so that `s[k] ^ count_flip[k]` is all
+ * ones exactly for the cells whose count bit matches. ANDing the four gives the cells with this
+ * count.
+ */
+
+struct LifeRuleTerm {
+    uint64_t count_flip[4]; // Per bit of the count: all ones if that bit must be 0
+    uint64_t born; // All ones if a dead cell with this count comes alive
+    uint64_t survives; // All ones if a live cell with this count stays alive
+};
+
+/**
+ * @struct LifeRuleProgram
+ * @brief A Life-like rule compiled into bitwise terms over the bit-sliced neighbour count.
+ */
+
+struct LifeRuleProgram {
+    bool conway; // True for B3/S23, which the kernels evaluate with a shorter expression
+    int term_count; // Number of entries in `terms`
+    struct LifeRuleTerm terms[LIFE_RULE_MAX_TERMS]; // Counts that lead to a live cell
+};
+
+/**
+ * @struct LifeChangeSet
+ * @brief The cells that came alive or died in the last generation, recorded while stepping once
+ *        enabled with life_grid_track_changes().
+ *
+ * `births` and `deaths` hold one bit per cell in the layout of the grid rows without their halo:
+ * cell (x, y) is bit `x % 64` of word `y * words + x / 64`. They are only up to date in the tiles
+ * flagged in the grid's `tile_changed`, since no other tile changed, so a consumer that visits the
+ * flagged tiles only does work in proportion to the changes rather than to the grid.
+ *
+ * The set describes a single generation: after an advance by several generations, the last one.
+ * It is not `valid` after edits, or after engines that rewrite the whole grid (HashLife and the
+ * sparse universe), until the next generation computed by another engine.
+ */
+
+struct LifeChangeSet {
+    uint64_t *births; // Per cell: 1 if it came alive (NULL if changes are not tracked)
+    uint64_t *deaths; // Per cell: 1 if it died
+    uint64_t birth_count; // Number of cells that came alive
+    uint64_t death_count; // Number of cells that died
+    uint32_t *tile_row_births; // Per row of tiles: births counted for the generation in progress
+    uint32_t *tile_row_deaths; // Per row of tiles: deaths counted for the generation in progress
+    bool valid; // True if the set matches the last generation
+};
+
+/**
+ * @struct LifeCycleDetector
+ * @brief Recognizes when the grid returns to an earlier generation, once enabled with
+ *        life_grid_detect_cycles().
+ *
+ * Every tile keeps a 64-bit hash of its cells, which only has to be recomputed where a tile
+ * changed; the grid hash is the sum of the tile hashes. The hashes of the last
+ * LIFE_CYCLE_HISTORY generations are kept, so a period shorter than that shows up as a repeated
+ * hash. A repeat is only a candidate until the generation it was seen at comes back cell for cell
+ * one period later, which rules out hash collisions. From then on the grid is known to cycle
+ * (a still life has period 1), and life_engine_advance() skips whole periods instead of
+ * computing them. Any edit starts the detection over.
+ */
+
+struct LifeCycleDetector {
+    uint64_t *tile_hashes; // Per tile: hash of its cells (NULL if cycles are not detected)
+    uint64_t *tile_row_hashes; // Per row of tiles: sum of its tile hashes
+    uint64_t *history; // Grid hash of generation n at `n % LIFE_CYCLE_HISTORY`
+    uint64_t observed; // Number of consecutive generations up to `generation` in `history`
+    uint64_t generation; // Generation hashed last
+    uint64_t edits; // Grid edit counter when the hashes were last rebuilt
+    uint64_t candidate; // Period suggested by a repeated hash and awaiting proof, or 0
+    uint64_t *snapshot; // Live cells of the generation the candidate is checked against
+    uint8_t *snapshot_states; // Cell states of that generation under a Generations rule
+    uint64_t snapshot_hash; // Grid hash of that generation
+    uint64_t snapshot_generation; // That generation
+    uint64_t period; // Proven period, or 0 while the grid is not known to cycle
+};
+
+/**
+ * @struct LifeGrid
+ * @brief A bit-packed, double-buffered grid of cells.
+ *
+ * Cell (x, y) lives in bit `x % 64` of word `y * words + x / 64`. Bits past `width` in the last
+ * word of a row are padding, not cells: they hold the east halo described below, so they are
+ * only meaningful as neighbours and must be masked off wherever cells are read.
+ *
+ * The grid is also divided into tiles of one word by LIFE_TILE_ROWS rows. A tile is only
+ * recomputed if it or one of its eight neighbouring tiles changed in the previous generation;
+ * every other tile is stable and is skipped.
+ *
+ * Every row is stored with one halo word on each side, and the grid with one halo row above and
+ * below, so kernels can read all neighbours of an edge cell without checking coordinates. Rows
+ * start on a cache line boundary: the west halo word is the last word of the line before, and
+ * the stride is padded to a whole number of cache lines. The halo of the current generation is
+ * refreshed from the opposite edges before each generation according to `topology`. When the
+ * width is not a multiple of 64, the padding bits of the last word serve as the east halo
+ * instead; they may be set, so code comparing whole words must mask the last one with
+ * `last_mask`.
+ *
+ * The next generation is computed into the back buffer and the two buffers then swap roles, so
+ * the current generation is only ever reached through life_grid_front() (or the accessors built
+ * on it). Skipped tiles are never written, which is safe because the buffers only ever differ
+ * in tiles flagged in `tile_changed`, and those are always recomputed.
+ *
+ * Under a Generations rule the grid also keeps the state of every cell in `states`, one byte
+ * per cell, while the bit-packed buffers keep holding the live cells (state 1) that the kernels
+ * count. The state plane is updated in place, since the next state of a cell only depends on its
+ * own state and on the live cells around it. Cells in a decay state change every generation, so
+ * the tiles holding them never fall asleep.
+ */
+
+struct LifeGrid {
+    int width; // Number of cells horizontally
+    int height; // Number of cells vertically
+    int words; // Number of 64-bit words per row
+    int stride; // Words between the starts of consecutive rows (a multiple of LIFE_ROW_OFFSET)
+    uint64_t last_mask; // Mask of the valid cell bits in the last word of a row
+    enum LifeTopology topology; // How the grid edges connect
+    struct LifeRule rule; // Rule every engine applies to this grid
+    struct LifeRuleProgram program; // `rule` compiled for the row kernels by life_grid_set_rule()
+    uint64_t *front; // Current generation, halo rows included
+    uint64_t *back; // Previous generation, overwritten with the next one while stepping
+    uint64_t *zero; // One all-dead row (with halo words) for reads past the bottom halo row
+    uint8_t *states; // Generations rules only: cell states in rows of `words * 64` bytes, or NULL
+    uint64_t generation; // Number of generations simulated since the grid was created
+    uint64_t edits; // Incremented on every change made through the accessors below
+    int tile_rows; // Number of rows of tiles (there are `words` tiles per row)
+    uint8_t *tile_changed; // Per tile: 1 if any cell changed in the last generation or edit
+    uint8_t *tile_next_changed; // Change flags being collected for the generation in progress
+    uint8_t *tile_active; // Per tile: 1 if it must be recomputed this generation
+    uint8_t *tile_row_active; // Per row of tiles: 1 if any of its tiles is active
+    struct LifeChangeSet changes; // Births and deaths of the last generation, if tracked
+    struct LifeCycleDetector cycle; // Repeated generations, if detected
+};
+
+/**
+ * @struct LifeEngine
+ * @brief A selectable stepping engine.
+ *
+ * All engines produce the same generations from the same grid; they differ in how the work is
+ * done. Engines may keep private state between calls, which `reset` discards. Unbounded engines
+ * treat the grid as a window onto an infinite plane and provide `set_cell` to place cells
+ * outside that window. Engines that only implement rules on the 3x3 neighbourhood with two
+ * states leave `extended_rules` clear and are stood in for by the bitwise engine while a
+ * Generations or Larger than Life rule is in effect.
+ */
+
+/**
+ * @brief Receives one live cell of the plane of an unbounded engine.
+ * @param ctx Caller-supplied context pointer.
+ * @param x X-coordinate of the cell (the grid window starts at 0).
+ * @param y Y-coordinate of the cell.
+ */
+
+typedef void (*LifeCellVisitor)(void *ctx, int64_t x, int64_t y);
+
+struct LifeEngine {
+    const char *name; // Short name used on the command line and in the window title
+    void (*advance)(struct LifeGrid *g, uint64_t generations); // Steps the grid forward
+    void (*reset)(void); // Frees any private engine state (may be NULL)
+    void (*set_cell)(int64_t x, int64_t y, bool alive); // Sets a cell outside the grid (may be NULL)
+    void (*visit_cells)(LifeCellVisitor visit, void *ctx); // Lists every live cell of the plane
+                                                           // (NULL for bounded engines)
+    bool extended_rules; // True if the engine supports Generations and Larger than Life rules
+    bool memoized; // True if results are cached per power-of-two step, so a step of 2^k
+                   // generations costs about as much as one of 2^(k-1) (HashLife)
+};
+
+extern const struct LifeEngine life_engines[]; // All available engines, default first
+extern const int life_engine_count; // Number of entries in `life_engines`
+extern const char *const life_topology_names[LIFE_TOPOLOGY_COUNT]; // Names indexed by topology
+
+bool life_grid_init(struct LifeGrid *g, int width, int height);
+void life_grid_free(struct LifeGrid *g);
+void life_grid_clear(struct LifeGrid *g);
+uint64_t life_grid_population(const struct LifeGrid *g);
+void life_grid_mark_all(struct LifeGrid *g);
+bool life_grid_track_changes(struct LifeGrid *g, bool enable);
+bool life_grid_detect_cycles(struct LifeGrid *g, bool enable);
+void life_grid_set_topology(struct LifeGrid *g, enum LifeTopology topology);
+bool life_topology_parse(const char *name, enum LifeTopology *topology);
+bool life_grid_set_rule(struct LifeGrid *g, const struct LifeRule *rule);
+bool life_rule_parse(const char *text, struct LifeRule *rule);
+void life_rule_format(const struct LifeRule *rule, char *text, size_t size);
+void life_grid_refresh_halo(struct LifeGrid *g);
+void life_grid_step(struct LifeGrid *g);
+void life_grid_swap(struct LifeGrid *g);
+const struct LifeEngine *life_engine_current(void);
+const struct LifeEngine *life_engine_for_grid(const struct LifeGrid *g);
+bool life_engine_visit_cells(struct LifeGrid *g, LifeCellVisitor visit, void *ctx);
+bool life_engine_select(const char *name);
+void life_engine_advance(struct LifeGrid *g, uint64_t generations);
+bool life_engine_place(struct LifeGrid *g, int64_t x, int64_t y, bool alive);
+void life_engine_clear(struct LifeGrid *g);
+const char *life_engine_kernel_name(void);
+bool life_engine_set_kernel(const char *name);
+bool life_engine_set_threads(int threads);
+void life_engine_shutdown(void);
+
+/**
+ * @brief Returns the buffer holding the current generation, `stride * (height + 2)` words long
+ *        including the halo rows.
+ */
+
+static inline uint64_t *life_grid_front(const struct LifeGrid *g) {
+    return g->front;
+}
+
+/**
+ * @brief Returns a pointer to the first word of row `y` of the current generation. Rows -1 and
+ *        `height` are the halo rows, and index -1 and `words` of each row its halo words.
+ */
+
+static inline uint64_t *life_grid_row(const struct LifeGrid *g, int y) {
+    return life_grid_front(g) + (size_t) (y + 1) * g->stride + LIFE_ROW_OFFSET;
+}
+
+/**
+ * @brief Returns a pointer to the first word of row `y` of the back buffer.
+ */
+
+static inline uint64_t *life_grid_back_row(const struct LifeGrid *g, int y) {
+    return g->back + (size_t) (y + 1) * g->stride + LIFE_ROW_OFFSET;
+}
+
+/**
+ * @brief Returns whether the cell at (x, y) is alive. Coordinates must be inside the grid.
+ */
+
+static inline bool life_grid_get(const struct LifeGrid *g, int x, int y) {
+    return (life_grid_row(g, y)[x / LIFE_WORD_BITS] >> (x % LIFE_WORD_BITS)) & 1;
+}
+
+/**
+ * @brief Returns a pointer to the first cell state of row `y`. Only valid while the grid has a
+ *        state plane (see `states`).
+ */
+
+static inline uint8_t *life_grid_state_row(const struct LifeGrid *g, int y) {
+    return g->states + (size_t) y * g->words * LIFE_WORD_BITS;
+}
+
+/**
+ * @brief Returns the state of the cell at (x, y): 0 for dead, 1 for alive and 2 or more for the
+ *        decay states of Generations rules. Coordinates must be inside the grid.
+ */
+
+static inline uint8_t life_grid_get_state(const struct LifeGrid *g, int x, int y) {
+    return g->states ? life_grid_state_row(g, y)[x] : life_grid_get(g, x, y);
+}
+
+/**
+ * @brief Marks the tile holding cell (x, y) as changed so it is recomputed next generation.
+ */
+
+static inline void life_grid_mark(struct LifeGrid *g, int x, int y) {
+    g->tile_changed[(size_t) (y / LIFE_TILE_ROWS) * g->words + x / LIFE_WORD_BITS] = 1;
+    g->changes.valid = false;
+    g->edits++;
+}
+
+/**
+ * @brief Sets the cell at (x, y) alive or dead. Coordinates must be inside the grid.
+ */
+
+static inline void life_grid_set(struct LifeGrid *g, int x, int y, bool alive) {
+    uint64_t bit = (uint64_t) 1 << (x % LIFE_WORD_BITS);
+    uint64_t *word = &life_grid_row(g, y)[x / LIFE_WORD_BITS];
+    *word = alive ? (*word | bit) : (*word & ~bit);
+    if (g->states) life_grid_state_row(g, y)[x] = alive;
+    life_grid_mark(g, x, y);
+}
+
+/**
+ * @brief Sets the cell at (x, y) to a state below the rule's number of states. Without a state
+ *        plane only states 0 and 1 exist. Coordinates must be inside the grid.
+ */
+
+static inline void life_grid_set_state(struct LifeGrid *g, int x, int y, uint8_t state) {
+    life_grid_set(g, x, y, state == 1);
+    if (g->states) life_grid_state_row(g, y)[x] = state;
+}
+
+/**
+ * @brief Returns the period the grid is known to repeat with from its current generation on, or
+ *        0 if it is not known to cycle (see struct LifeCycleDetector).
+ */
+
+static inline uint64_t life_grid_cycle_period(const struct LifeGrid *g) {
+    return g->cycle.edits == g->edits ? g->cycle.period : 0;
+}
+
+/**
+ * @brief Flips the cell at (x, y) between alive and dead; a decaying cell comes alive.
+ *        Coordinates must be inside the grid.
+ */
+
+static inline void life_grid_toggle(struct LifeGrid *g, int x, int y) {
+    life_grid_row(g, y)[x / LIFE_WORD_BITS] ^= (uint64_t) 1 << (x % LIFE_WORD_BITS);
+    if (g->states) life_grid_state_row(g, y)[x] = life_grid_get(g, x, y);
+    life_grid_mark(g, x, y);
+}
+
+#endif
@@ -0,0 +1,442 @@
+/**
+ * @file life_history.c
+ * @brief Rewind history of keyframes and run-length encoded XOR deltas.
+ *
+ * A grid is recorded as an array of words: its rows with the padding bits cleared, followed by
+ * the cell states under a Generations rule. The XOR of two consecutive states is zero wherever
+ * nothing changed, so a delta is encoded as runs of zero words, each stored as a count, and the
+ * nonzero words after them, stored as a count followed by the words themselves. Counts take
+ * seven bits per byte (LEB128). Keyframes are the same encoding against an empty grid.
+ */
+
+#include "life_history.h" // for history declarations
+#include <SDL3/SDL.h> // for SDL memory functions and error reporting
+#include <string.h>
+
+/* --------------------------------------------------------------------------------------------
+ * Encoding
+ * --------------------------------------------------------------------------------------------
+ * The grid is encoded straight from its rows against the copy of the previous checkpoint in
+ * `current`, first to measure the encoding and then to write it, so the history needs no
+ * buffers beside `current`.
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @struct LifeHistoryEncoder
+ * @brief State of an encoding in progress.
+ */
+
+struct LifeHistoryEncoder {
+    uint8_t *out; // Receives the encoding, or NULL to only measure it
+    size_t size; // Bytes of encoding so far
+    size_t zeros; // Zero words met since the last nonzero one, not written yet
+};
+
+/**
+ * @brief Appends a count to an encoding, seven bits per byte.
+ */
+
+static void life_history_put_count(struct LifeHistoryEncoder *e, size_t count) {
+    do {
+        if (e->out) e->out[e->size] = (uint8_t) ((count & 0x7F) | (count >= 0x80 ? 0x80 : 0));
+        e->size++;
+        count >>= 7;
+    } while (count);
+}
+
+/**
+ * @brief Reads a count written by life_history_put_count().
+ * @param data Encoding.
+ * @param pos Read position, advanced past the count.
+ */
+
+static size_t life_history_get_count(const uint8_t *data, size_t *pos) {
+    size_t count = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t byte = data[(*pos)++];
+        count |= (size_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return count;
+    }
+}
+
+/**
+ * @brief Returns word `i` of a span XORed with the base.
+ * @param words Words of the span, as bytes since the cell states are stored as such.
+ * @param base Words the span is encoded against, or NULL.
+ * @param count Number of words in the span.
+ * @param last_mask Mask of the bits of the last word that belong to the grid.
+ * @param i Index of the word.
+ */
+
+static inline uint64_t life_history_delta(const uint8_t *words, const uint64_t *base,
+                                          size_t count, uint64_t last_mask, size_t i) {
+    uint64_t word;
+    memcpy(&word, words + i * sizeof(word), sizeof(word));
+    if (i == count - 1) word &= last_mask;
+    return base ? word ^ base[i] : word;
+}
+
+/**
+ * @brief Encodes a span of words against the same span of the base. Runs of zeros carry on
+ *        into the next span, while runs of nonzero words end with the span.
+ */
+
+static void life_history_encode_span(struct LifeHistoryEncoder *e, const uint8_t *words,
+                                     const uint64_t *base, size_t count, uint64_t last_mask) {
+    size_t i = 0;
+    while (i < count) {
+        size_t start = i;
+        while (i < count && !life_history_delta(words, base, count, last_mask, i)) i++;
+        e->zeros += i - start;
+        start = i;
+        while (i < count && life_history_delta(words, base, count, last_mask, i)) i++;
+        if (i == start) break;
+        life_history_put_count(e, e->zeros);
+        life_history_put_count(e, i - start);
+        e->zeros = 0;
+        for (size_t k = start; k < i; k++) {
+            uint64_t word = life_history_delta(words, base, count, last_mask, k);
+            if (e->out) memcpy(e->out + e->size, &word, sizeof(word));
+            e->size += sizeof(word);
+        }
+    }
+}
+
+/**
+ * @brief Encodes the grid against the base, or as it is if the base is NULL.
+ */
+
+static void life_history_encode(struct LifeHistoryEncoder *e, const struct LifeGrid *g,
+                                const uint64_t *base) {
+    size_t words = (size_t) g->words, cells = words * g->height;
+    for (int y = 0; y < g->height; y++) {
+        // The padding bits may hold the east halo
+        life_history_encode_span(e, (const uint8_t *) life_grid_row(g, y),
+                                 base ? base + (size_t) y * words : NULL, words, g->last_mask);
+    }
+    if (g->states) {
+        life_history_encode_span(e, g->states, base ? base + cells : NULL,
+                                 cells * LIFE_WORD_BITS / sizeof(uint64_t), ~(uint64_t) 0);
+    }
+    if (e->zeros) {
+        life_history_put_count(e, e->zeros);
+        life_history_put_count(e, 0);
+    }
+}
+
+/**
+ * @brief Applies an encoding to an array of words by XOR.
+ */
+
+static void life_history_decode(const uint8_t *data, size_t size, uint64_t *words) {
+    size_t pos = 0, i = 0;
+    while (pos < size) {
+        i += life_history_get_count(data, &pos);
+        size_t literals = life_history_get_count(data, &pos);
+        for (size_t k = 0; k < literals; k++, i++, pos += sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, data + pos, sizeof(word));
+            words[i] ^= word;
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Grid Access
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Returns the number of words a recording of the grid takes.
+ */
+
+static size_t life_history_grid_words(const struct LifeGrid *g) {
+    size_t cells = (size_t) g->words * g->height;
+    return g->states ? cells + cells * LIFE_WORD_BITS / sizeof(uint64_t) : cells;
+}
+
+/**
+ * @brief Copies the grid into an array of words.
+ */
+
+static void life_history_capture(const struct LifeGrid *g, uint64_t *out) {
+    size_t words = (size_t) g->words;
+    for (int y = 0; y < g->height; y++) {
+        uint64_t *row = out + (size_t) y * words;
+        memcpy(row, life_grid_row(g, y), words * sizeof(uint64_t));
+        row[words - 1] &= g->last_mask;
+    }
+    if (g->states) {
+        memcpy(out + words * g->height, g->states, words * LIFE_WORD_BITS * g->height);
+    }
+}
+
+/**
+ * @brief Overwrites the grid with an array of words made by life_history_capture().
+ */
+
+static void life_history_apply(struct LifeGrid *g, const uint64_t *in) {
+    size_t words = (size_t) g->words;
+    for (int y = 0; y < g->height; y++) {
+        memcpy(life_grid_row(g, y), in + (size_t) y * words, words * sizeof(uint64_t));
+    }
+    if (g->states) {
+        memcpy(g->states, in + words * g->height, words * LIFE_WORD_BITS * g->height);
+    }
+    life_grid_mark_all(g);
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Checkpoint List
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Drops the checkpoints from index `first` on.
+ */
+
+static void life_history_truncate(struct LifeHistory *h, int first) {
+    for (int i = first; i < h->count; i++) {
+        h->used -= h->checkpoints[i].size;
+        SDL_free(h->checkpoints[i].data);
+    }
+    if (first < h->count) h->count = first;
+    if (h->position >= h->count) h->position = h->count - 1;
+    // Deltas are counted from the last keyframe that remains
+    h->delta_bytes = 0;
+    for (int i = h->count - 1; i >= 0 && !h->checkpoints[i].keyframe; i--) {
+        h->delta_bytes += h->checkpoints[i].size;
+    }
+}
+
+/**
+ * @brief Drops the oldest keyframe with its deltas while the history is over budget, as long
+ *        as a later keyframe remains.
+ */
+
+static void life_history_trim(struct LifeHistory *h) {
+    while (h->used > h->budget) {
+        int next = 1;
+        while (next < h->count && !h->checkpoints[next].keyframe) next++;
+        if (next >= h->count) return;
+        for (int i = 0; i < next; i++) {
+            h->used -= h->checkpoints[i].size;
+            SDL_free(h->checkpoints[i].data);
+        }
+        memmove(h->checkpoints, h->checkpoints + next,
+                (size_t) (h->count - next) * sizeof(*h->checkpoints));
+        h->count -= next;
+        h->position -= next;
+    }
+}
+
+/**
+ * @brief Drops every checkpoint and frees the buffers, keeping the budget.
+ */
+
+static void life_history_reset(struct LifeHistory *h) {
+    life_history_truncate(h, 0);
+    SDL_free(h->checkpoints);
+    SDL_free(h->current);
+    life_history_init(h, h->budget);
+}
+
+/**
+ * @brief Allocates `current` for grids of `words` words.
+ * @return true on success, false if memory ran out or the grid takes over half the budget,
+ *         which leaves too little room for checkpoints.
+ */
+
+static bool life_history_allocate(struct LifeHistory *h, size_t words) {
+    size_t bytes = words * sizeof(uint64_t);
+    if (bytes > h->budget / 2) {
+        return SDL_SetError("History budget of %zu bytes is too small for this grid, which "
+                            "needs at least %zu", h->budget, 2 * bytes);
+    }
+    h->current = SDL_malloc(bytes);
+    if (!h->current) return false;
+    h->words = words;
+    h->used += bytes;
+    return true;
+}
+
+/**
+ * @brief Encodes the grid as a new checkpoint at the end of the list and makes it current.
+ * @param keyframe True to encode the grid itself, false to encode its XOR with `current`.
+ * @return true on success, false if memory ran out.
+ */
+
+static bool life_history_append(struct LifeHistory *h, const struct LifeGrid *g, bool keyframe,
+                                bool edit) {
+    if (h->count == h->capacity) {
+        int capacity = h->capacity ? h->capacity * 2 : 64;
+        struct LifeCheckpoint *checkpoints =
+            SDL_realloc(h->checkpoints, (size_t) capacity * sizeof(*checkpoints));
+        if (!checkpoints) return false;
+        h->used += (size_t) (capacity - h->capacity) * sizeof(*checkpoints);
+        h->checkpoints = checkpoints;
+        h->capacity = capacity;
+    }
+    const uint64_t *base = keyframe ? NULL : h->current;
+    struct LifeHistoryEncoder e = {0};
+    life_history_encode(&e, g, base);
+    size_t size = e.size;
+    uint8_t *data = SDL_malloc(size ? size : 1);
+    if (!data) return false;
+    e = (struct LifeHistoryEncoder) {.out = data};
+    life_history_encode(&e, g, base);
+
+    h->checkpoints[h->count++] = (struct LifeCheckpoint) {
+        g->generation, g->rule, keyframe, edit, data, size
+    };
+    life_history_capture(g, h->current);
+    h->used += size;
+    h->delta_bytes = keyframe ? 0 : h->delta_bytes + size;
+    h->position = h->count - 1;
+    h->edits = g->edits;
+    return true;
+}
+
+/**
+ * @brief Rebuilds checkpoint `index` from the keyframe before it and puts it on the grid.
+ * @return true on success, false if its rule could not be set.
+ */
+
+static bool life_history_restore(struct LifeHistory *h, struct LifeGrid *g, int index) {
+    const struct LifeCheckpoint *checkpoint = &h->checkpoints[index];
+    if (memcmp(&checkpoint->rule, &g->rule, sizeof(g->rule)) != 0 &&
+        !life_grid_set_rule(g, &checkpoint->rule)) {
+        return false;
+    }
+    if (life_history_grid_words(g) != h->words) {
+        return SDL_SetError("Checkpoint does not match the grid");
+    }
+
+    int keyframe = index;
+    while (!h->checkpoints[keyframe].keyframe) keyframe--;
+    memset(h->current, 0, h->words * sizeof(uint64_t));
+    for (int i = keyframe; i <= index; i++) {
+        life_history_decode(h->checkpoints[i].data, h->checkpoints[i].size, h->current);
+    }
+    // Also drops what an unbounded engine kept outside the grid
+    life_engine_clear(g);
+    life_history_apply(g, h->current);
+    g->generation = checkpoint->generation;
+    h->position = index;
+    h->edits = g->edits;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Public Interface
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Sets up an empty history.
+ * @param h History to set up.
+ * @param budget Most bytes the history may hold, or 0 to record nothing.
+ */
+
+void life_history_init(struct LifeHistory *h, size_t budget) {
+    memset(h, 0, sizeof(*h));
+    h->budget = budget;
+    h->position = -1;
+}
+
+/**
+ * @brief Frees every checkpoint and buffer of the history, which records nothing from then on.
+ */
+
+void life_history_free(struct LifeHistory *h) {
+    life_history_reset(h);
+    h->budget = 0;
+}
+
+/**
+ * @brief Records the grid as a new checkpoint, unless it has not changed since the current one.
+ *        Checkpoints ahead of the current one, left by a rewind or undo, are dropped first.
+ *        Before an edit, the checkpoint is marked as a point undo returns to, even if it was
+ *        already recorded.
+ *
+ * A new keyframe is started once the deltas since the last one outgrow it or an eighth of the
+ * budget, so rebuilding a checkpoint never decodes much more than two keyframes' worth, and the
+ * oldest checkpoints can be dropped in small groups to stay within the budget.
+ *
+ * @param h History to record in.
+ * @param g Grid to record.
+ * @param edit True if the grid is about to be edited.
+ * @return true on success (or if the history is disabled), false if memory ran out or the
+ *         grid is too large for the budget, which also empties the history.
+ */
+
+bool life_history_record(struct LifeHistory *h, const struct LifeGrid *g, bool edit) {
+    if (!h->budget) return true;
+    if (h->position >= 0 && h->edits == g->edits &&
+        h->checkpoints[h->position].generation == g->generation) {
+        h->checkpoints[h->position].edit |= edit;
+        return true;
+    }
+    life_history_truncate(h, h->position + 1);
+
+    // Switching between Life-like and Generations rules changes the size of a recording
+    size_t words = life_history_grid_words(g);
+    if (words != h->words) {
+        life_history_reset(h);
+        if (!life_history_allocate(h, words)) return false;
+    }
+    size_t keyframe_size = 0;
+    for (int i = h->count - 1; i >= 0 && !keyframe_size; i--) {
+        if (h->checkpoints[i].keyframe) keyframe_size = h->checkpoints[i].size;
+    }
+    bool keyframe = h->count == 0 || h->delta_bytes > keyframe_size ||
+                    h->delta_bytes > h->budget / 8;
+    if (!life_history_append(h, g, keyframe, edit)) return false;
+
+    life_history_trim(h);
+    if (h->used > h->budget) {
+        // The only keyframe left and its deltas are over budget: start over from this grid
+        life_history_truncate(h, 0);
+        if (!life_history_append(h, g, true, edit)) return false;
+        if (h->used > h->budget) {
+            life_history_reset(h);
+            return SDL_SetError("History budget of %zu bytes is too small for this grid",
+                                h->budget);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Puts the grid back to how it was before the last edit: the last checkpoint before the
+ *        current one that was recorded before an edit, skipping those taken while running. The
+ *        grid is recorded first if it changed, so nothing is lost.
+ * @return true on success, false if there is nothing to go back to.
+ */
+
+bool life_history_undo(struct LifeHistory *h, struct LifeGrid *g) {
+    if (!life_history_record(h, g, false)) return false;
+    int index = h->position - 1;
+    while (index >= 0 && !h->checkpoints[index].edit) index--;
+    if (index < 0) return SDL_SetError("Nothing to undo");
+    return life_history_restore(h, g, index);
+}
+
+/**
+ * @brief Takes the grid back to an earlier generation: the last checkpoint at or before it is
+ *        restored and advanced the rest of the way.
+ * @param h History to rewind in.
+ * @param g Grid to rewind.
+ * @param generation Generation to go back to.
+ * @return true on success, false if the generation is no longer in the history.
+ */
+
+bool life_history_rewind(struct LifeHistory *h, struct LifeGrid *g, uint64_t generation) {
+    if (!life_history_record(h, g, false)) return false;
+    int index = h->position;
+    while (index >= 0 && h->checkpoints[index].generation > generation) index--;
+    if (index < 0) {
+        return SDL_SetError("Generation %llu is no longer in the history",
+                            (unsigned long long) generation);
+    }
+    if (!life_history_restore(h, g, index)) return false;
+    if (generation > g->generation) life_engine_advance(g, generation - g->generation);
+    return true;
+}
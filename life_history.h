@@ -0,0 +1,64 @@
+/**
+ * @file life_history.h
+ * @brief Declarations for the rewind history: recent states of a grid kept within a budget.
+ *
+ * The history is a list of checkpoints, oldest first. A keyframe stores a whole grid and every
+ * later checkpoint only the XOR of its grid with the one before, and both are run-length
+ * encoded over 64-bit words, so empty space and unchanged regions cost next to nothing. A past
+ * checkpoint is rebuilt by decoding the nearest keyframe before it and applying the deltas up
+ * to it. When the history outgrows its budget, the oldest keyframe is dropped together with
+ * its deltas.
+ *
+ * Only the cells inside the grid are kept: unbounded engines lose what lay outside it when a
+ * checkpoint is restored.
+ */
+
+#ifndef LIFE_HISTORY_H
+#define LIFE_HISTORY_H
+
+#include "life_engine.h" // for the grid being recorded
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @struct LifeCheckpoint
+ * @brief One recorded state of the grid.
+ */
+
+struct LifeCheckpoint {
+    uint64_t generation; // Generation number of the grid
+    struct LifeRule rule; // Rule the grid ran under
+    bool keyframe; // True if `data` encodes the grid itself, false if its XOR with the previous
+    bool edit; // True if recorded just before an edit, as a point undo returns to
+    uint8_t *data; // Run-length encoded words
+    size_t size; // Bytes in `data`
+};
+
+/**
+ * @struct LifeHistory
+ * @brief Checkpoints of a grid, and the grid as of the current checkpoint for encoding the
+ *        next delta against. That copy is the only buffer the size of the grid the history
+ *        needs, and it counts towards the budget.
+ */
+
+struct LifeHistory {
+    size_t budget; // Most bytes the history may hold, buffers included
+    size_t used; // Bytes held
+    struct LifeCheckpoint *checkpoints; // Recorded states, oldest first
+    int count; // Number of checkpoints
+    int capacity; // Number of checkpoints `checkpoints` has room for
+    int position; // Checkpoint the grid was last recorded at or restored to, or -1
+    uint64_t edits; // Grid edit counter at that time
+    uint64_t *current; // The grid at `position`, as words (NULL until the first checkpoint)
+    size_t words; // Words in `current`
+    size_t delta_bytes; // Bytes of the deltas since the last keyframe
+};
+
+void life_history_init(struct LifeHistory *h, size_t budget);
+void life_history_free(struct LifeHistory *h);
+bool life_history_record(struct LifeHistory *h, const struct LifeGrid *g, bool edit);
+bool life_history_undo(struct LifeHistory *h, struct LifeGrid *g);
+bool life_history_rewind(struct LifeHistory *h, struct LifeGrid *g, uint64_t generation);
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * @file life_kernel.h
+ * @brief Internal row kernels shared by the Game of Life stepping engines.
+ *
+ * A row kernel computes the next generation of one packed row from the rows above and below
+ * it. The scalar kernel works on one 64-bit word at a time; life_simd.c provides SSE2, AVX2 and
+ * AVX-512 versions of the same computation, and the fastest one the CPU supports is selected at
+ * startup.
+ */
+
+#ifndef LIFE_KERNEL_H
+#define LIFE_KERNEL_H
+
+#include "life_engine.h" // for rule definitions
+#include <stdbool.h>
+#include <stdint.h>
+
+void life_rule_compile(const struct LifeRule *rule, struct LifeRuleProgram *program);
+
+/**
+ * @brief Computes the next generation of words [w0, w1) of one row.
+ *
+ * Rows carry a halo word on each side (see struct LifeGrid), so words w0 - 1 and w1 of every
+ * input row may always be read and the kernels never branch on the position in the row.
+ *
+ * @param above Row above (may be the top halo row).
+ * @param row Row being updated.
+ * @param below Row below (may be the bottom halo row).
+ * @param out Destination row. Bits past the grid width are left unmasked.
+ * @param w0 First word to compute.
+ * @param w1 One past the last word to compute (w0 < w1 <= words).
+ * @param program Compiled rule to apply.
+ */
+
+typedef void (*LifeRowKernel)(const uint64_t *above, const uint64_t *row, const uint64_t *below,
+                              uint64_t *out, int w0, int w1, const struct LifeRuleProgram *program);
+
+/**
+ * @struct LifeKernelInfo
+ * @brief Describes one row kernel variant and whether the running CPU can execute it.
+ */
+
+struct LifeKernelInfo {
+    const char *name; // Short name used on the command line and in logs
+    LifeRowKernel kernel; // Row kernel entry point
+    bool (*supported)(void); // Returns true if the CPU can run this kernel
+};
+
+extern const struct LifeKernelInfo life_kernels[]; // Kernels from slowest to fastest
+extern const int life_kernel_count; // Number of entries in `life_kernels`
+
+void life_step_row_scalar(const uint64_t *above, const uint64_t *row, const uint64_t *below,
+                          uint64_t *out, int w0, int w1, const struct LifeRuleProgram *program);
+void life_age_cells(uint8_t *states, uint64_t *out, int w0, int w1, uint8_t last,
+                    uint8_t *changed);
+LifeRowKernel life_grid_kernel(void);
+void life_grid_refresh_row_halo(const struct LifeGrid *g, uint64_t *row);
+void life_mirror_row(const struct LifeGrid *g, const uint64_t *src, uint64_t *dst);
+
+/**
+ * @brief Returns the number of bits set in a word.
+ */
+
+static inline int life_popcount(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(v);
+#else
+    v -= (v >> 1) & 0x5555555555555555ull;
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int) ((v * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/**
+ * @brief Records the births and deaths of word `i` of row `y` in the grid's change set, which
+ *        must be tracked. Both words must already be masked to the grid width.
+ * @param before The word in the previous generation.
+ * @param after The word in the new generation.
+ */
+
+static inline void life_record_changes(struct LifeGrid *g, int y, int i, uint64_t before,
+                                       uint64_t after) {
+    struct LifeChangeSet *changes = &g->changes;
+    size_t index = (size_t) y * g->words + i;
+    uint64_t born = after & ~before, died = before & ~after;
+    changes->births[index] = born;
+    changes->deaths[index] = died;
+    if (born | died) {
+        changes->tile_row_births[y / LIFE_TILE_ROWS] += (uint32_t) life_popcount(born);
+        changes->tile_row_deaths[y / LIFE_TILE_ROWS] += (uint32_t) life_popcount(died);
+    }
+}
+
+/**
+ * @brief Counts the live neighbours of the 64 cells in one word.
+ *
+ * Each row is passed as the word itself plus its west and east neighbour words, whose edge bits
+ * are shifted in so that every cell lines up with its horizontal neighbours. The eight neighbour
+ * bitboards are then summed with half and full adders into a bit-sliced count.
+ *
+ * @param s Receives the count: bit k of cell x's count is bit x of `s[k]`.
+ */
+
+static inline void life_count_word(uint64_t aw, uint64_t a, uint64_t ae,
+                                   uint64_t cw, uint64_t c, uint64_t ce,
+                                   uint64_t bw, uint64_t b, uint64_t be, uint64_t s[4]) {
+    // Align the west and east neighbours of every cell with the cell itself
+    uint64_t a_w = (a << 1) | (aw >> 63), a_e = (a >> 1) | (ae << 63);
+    uint64_t c_w = (c << 1) | (cw >> 63), c_e = (c >> 1) | (ce << 63);
+    uint64_t b_w = (b << 1) | (bw >> 63), b_e = (b >> 1) | (be << 63);
+
+    // Row above: full adder of three cells gives a 2-bit count (a1 a0)
+    uint64_t a_x = a_w ^ a;
+    uint64_t a0 = a_x ^ a_e;
+    uint64_t a1 = (a_w & a) | (a_x & a_e);
+    // Own row: half adder of the two side cells gives (c1 c0)
+    uint64_t c0 = c_w ^ c_e;
+    uint64_t c1 = c_w & c_e;
+    // Row below: full adder again gives (b1 b0)
+    uint64_t b_x = b_w ^ b;
+    uint64_t b0 = b_x ^ b_e;
+    uint64_t b1 = (b_w & b) | (b_x & b_e);
+
+    // Bit 0 of the total and its carry
+    uint64_t s_x = a0 ^ c0;
+    s[0] = s_x ^ b0;
+    uint64_t k0 = (a0 & c0) | (s_x & b0);
+    // Bit 1 of the total from the four weight-2 inputs
+    uint64_t t = a1 ^ c1, t_c = a1 & c1;
+    uint64_t u = b1 ^ k0, u_c = b1 & k0;
+    s[1] = t ^ u;
+    // The three carries into bit 2 sum to at most 2, since the count never exceeds 8
+    uint64_t m = t & u;
+    s[2] = t_c ^ u_c ^ m;
+    s[3] = (t_c & u_c) | (t_c & m) | (u_c & m);
+}
+
+/**
+ * @brief Applies a compiled rule to a word of cells given their bit-sliced neighbour counts.
+ * @param program Compiled rule.
+ * @param c Current state of the cells.
+ * @param s Neighbour counts from life_count_word().
+ * @return The word of cells for the next generation.
+ */
+
+static inline uint64_t life_rule_apply(const struct LifeRuleProgram *program, uint64_t c,
+                                       const uint64_t s[4]) {
+    // Survival with 2 or 3 neighbours, birth with exactly 3; any bit above 1 means 4 or more
+    if (program->conway) return s[1] & (s[0] | c) & ~(s[2] | s[3]);
+
+    uint64_t next = 0;
+    for (int i = 0; i < program->term_count; i++) {
+        const struct LifeRuleTerm *term = &program->terms[i];
+        uint64_t match = (s[0] ^ term->count_flip[0]) & (s[1] ^ term->count_flip[1]) &
+                         (s[2] ^ term->count_flip[2]) & (s[3] ^ term->count_flip[3]);
+        next |= match & ((c & term->survives) | (~c & term->born));
+    }
+    return next;
+}
+
+/**
+ * @brief Computes the next state of the 64 cells in one word under a compiled rule.
+ * @return The word of cells for the next generation.
+ */
+
+static inline uint64_t life_next_word(const struct LifeRuleProgram *program,
+                                      uint64_t aw, uint64_t a, uint64_t ae,
+                                      uint64_t cw, uint64_t c, uint64_t ce,
+                                      uint64_t bw, uint64_t b, uint64_t be) {
+    uint64_t s[4];
+    life_count_word(aw, a, ae, cw, c, ce, bw, b, be, s);
+    return life_rule_apply(program, c, s);
+}
+
+/**
+ * @brief Computes word `i` of a row from its neighbour words, halo words included.
+ */
+
+static inline uint64_t life_next_word_at(const struct LifeRuleProgram *program,
+                                         const uint64_t *above, const uint64_t *row,
+                                         const uint64_t *below, int i) {
+    return life_next_word(program, above[i - 1], above[i], above[i + 1], row[i - 1], row[i],
+                          row[i + 1], below[i - 1], below[i], below[i + 1]);
+}
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * @file life_ltl.c
+ * @brief Larger than Life stepping with summed-area tables.
+ *
+ * Every active row of tiles is computed as one strip. The live cells of the strip, extended by
+ * `range` rows and columns on every side as the topology connects the edges, are accumulated
+ * into a summed-area table, from which the count of a square (Moore) neighbourhood of any radius
+ * takes four lookups. Diamond (von Neumann) neighbourhoods take eight lookups into two tables
+ * that accumulate the row prefix sums along the two diagonals instead.
+ *
+ * The tables only ever cover one strip, so they grow with the width of the grid but not with
+ * its height. Entries are 32-bit and may wrap around on very wide grids; the differences taken
+ * from them are still exact, since every neighbourhood count fits easily.
+ */
+
+#include "life_ltl.h" // for Larger than Life declarations
+#include "life_kernel.h" // for the Generations state update
+#include <SDL3/SDL.h> // for SDL memory functions
+#include <string.h>
+
+/**
+ * @struct LifeLtlScratch
+ * @brief Table memory owned by one worker thread.
+ */
+
+struct LifeLtlScratch {
+    uint32_t *tables; // Summed-area table, or the two diagonal tables one after the other
+    size_t capacity; // Number of entries `tables` can hold
+};
+
+static struct LifeLtlScratch *scratch = NULL; // One entry per worker thread
+static int scratch_count = 0; // Number of entries in `scratch`
+
+/* --------------------------------------------------------------------------------------------
+ * Scratch Memory
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Returns the number of table entries one strip of the grid needs under its rule.
+ */
+
+static size_t life_ltl_table_size(const struct LifeGrid *g) {
+    size_t columns = (size_t) g->width + 2 * g->rule.range + 1;
+    size_t rows = (size_t) LIFE_TILE_ROWS + 2 * g->rule.range + 1;
+    return columns * rows * (g->rule.von_neumann ? 2 : 1);
+}
+
+/**
+ * @brief Makes sure the first `jobs` worker threads have tables large enough for the grid.
+ * @param g Grid about to be stepped under a Larger than Life rule.
+ * @param jobs Number of worker threads that will step it.
+ * @return true if the tables are available, false if memory ran out.
+ */
+
+bool life_ltl_reserve(const struct LifeGrid *g, int jobs) {
+    if (jobs > scratch_count) {
+        struct LifeLtlScratch *grown = SDL_realloc(scratch, (size_t) jobs * sizeof(*scratch));
+        if (!grown) return false;
+        memset(grown + scratch_count, 0, (size_t) (jobs - scratch_count) * sizeof(*grown));
+        scratch = grown;
+        scratch_count = jobs;
+    }
+    size_t size = life_ltl_table_size(g);
+    for (int i = 0; i < jobs; i++) {
+        if (scratch[i].capacity >= size) continue;
+        SDL_free(scratch[i].tables);
+        scratch[i].tables = SDL_malloc(size * sizeof(uint32_t));
+        scratch[i].capacity = scratch[i].tables ? size : 0;
+        if (!scratch[i].tables) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Frees the tables of all worker threads.
+ */
+
+void life_ltl_free(void) {
+    for (int i = 0; i < scratch_count; i++) SDL_free(scratch[i].tables);
+    SDL_free(scratch);
+    scratch = NULL;
+    scratch_count = 0;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Tables
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Finds the stored row holding row `y` of the plane, which may lie beyond the top or
+ *        bottom edge (even several times over, on grids smaller than the range).
+ * @param mirrored Set if the row must be read mirrored left to right.
+ * @return The row, or NULL if it lies in the dead border.
+ */
+
+static const uint64_t *life_ltl_source_row(const struct LifeGrid *g, int y, bool *mirrored) {
+    *mirrored = false;
+    if (y >= 0 && y < g->height) return life_grid_row(g, y);
+    if (g->topology == LIFE_TOPOLOGY_DEAD) return NULL;
+    int wraps = y >= 0 ? y / g->height : -((-y - 1) / g->height) - 1;
+    // Every trip across the top or bottom edge of a Klein bottle mirrors the plane
+    *mirrored = g->topology == LIFE_TOPOLOGY_KLEIN && (wraps & 1);
+    return life_grid_row(g, y - wraps * g->height);
+}
+
+/**
+ * @brief Returns 1 if cell `x` of a stored row is alive. `x` may lie beyond either edge.
+ */
+
+static inline uint32_t life_ltl_cell(const struct LifeGrid *g, const uint64_t *row, bool mirrored,
+                                     int x) {
+    if (x < 0 || x >= g->width) {
+        if (g->topology == LIFE_TOPOLOGY_DEAD) return 0;
+        x = (x % g->width + g->width) % g->width;
+    }
+    if (mirrored) x = g->width - 1 - x;
+    return (row[x / LIFE_WORD_BITS] >> (x % LIFE_WORD_BITS)) & 1;
+}
+
+/**
+ * @brief Fills the tables for the strip of rows [y0, y0 + height).
+ *
+ * Row r of the strip is row `y0 - range + r` of the plane, and column c is column `c - range`.
+ * With Q(r, c) the number of live cells in row r left of column c, table row r + 1 is built
+ * from row r (table row 0 being all zeros):
+ * - square neighbourhoods: `sums[r + 1][c] = sums[r][c] + Q(r, c)`, so a box of rows and
+ *   columns is the usual difference of four corners;
+ * - diamond neighbourhoods: `left[r + 1][c] = left[r][c - 1] + Q(r, c)` and
+ *   `right[r + 1][c] = right[r][c + 1] + Q(r, c)`, which sum Q along the diagonals running up
+ *   to the left and up to the right. Every row of a diamond is a difference of two values of Q
+ *   whose columns move by one per row, so each of its four slanted sides is a difference of two
+ *   diagonal sums.
+ */
+
+static void life_ltl_build(const struct LifeGrid *g, int y0, int height, uint32_t *tables) {
+    int range = g->rule.range, columns = g->width + 2 * range + 1;
+    uint32_t *left = tables, *right = tables + (size_t) columns * (LIFE_TILE_ROWS + 2 * range + 1);
+    memset(left, 0, (size_t) columns * sizeof(uint32_t));
+    if (g->rule.von_neumann) memset(right, 0, (size_t) columns * sizeof(uint32_t));
+
+    for (int r = 0; r < height + 2 * range; r++) {
+        bool mirrored;
+        const uint64_t *row = life_ltl_source_row(g, y0 - range + r, &mirrored);
+        const uint32_t *left_above = left + (size_t) r * columns;
+        uint32_t *left_row = left + (size_t) (r + 1) * columns;
+        uint32_t q = 0;
+
+        if (!g->rule.von_neumann) {
+            for (int c = 0; c < columns; c++) {
+                left_row[c] = left_above[c] + q;
+                if (row && c + 1 < columns) q += life_ltl_cell(g, row, mirrored, c - range);
+            }
+            continue;
+        }
+        const uint32_t *right_above = right + (size_t) r * columns;
+        uint32_t *right_row = right + (size_t) (r + 1) * columns;
+        for (int c = 0; c < columns; c++) {
+            left_row[c] = (c > 0 ? left_above[c - 1] : 0) + q;
+            right_row[c] = (c + 1 < columns ? right_above[c + 1] : 0) + q;
+            if (row && c + 1 < columns) q += life_ltl_cell(g, row, mirrored, c - range);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Stepping
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Computes the active tiles of tile row `ty` into the back buffer and records which of
+ *        them changed.
+ */
+
+static void life_ltl_step_strip(struct LifeGrid *g, int ty, uint32_t *tables) {
+    const struct LifeRule *rule = &g->rule;
+    int range = rule->range, columns = g->width + 2 * range + 1, words = g->words;
+    const uint32_t *left = tables;
+    const uint32_t *right = tables + (size_t) columns * (LIFE_TILE_ROWS + 2 * range + 1);
+    const uint8_t *active = g->tile_active + (size_t) ty * words;
+    uint8_t *changed = g->tile_next_changed + (size_t) ty * words;
+    int y0 = ty * LIFE_TILE_ROWS;
+    int y1 = y0 + LIFE_TILE_ROWS < g->height ? y0 + LIFE_TILE_ROWS : g->height;
+    life_ltl_build(g, y0, y1 - y0, tables);
+
+    for (int y = y0; y < y1; y++) {
+        const uint64_t *row = life_grid_row(g, y);
+        uint64_t *out = life_grid_back_row(g, y);
+        // Table rows just above the neighbourhood, level with the cell, and at its bottom edge
+        size_t top = (size_t) (y - y0) * columns;
+        size_t mid = top + (size_t) (range + 1) * columns;
+        size_t bottom = top + (size_t) (2 * range + 1) * columns;
+
+        for (int i = 0; i < words; i++) {
+            if (!active[i]) continue;
+            uint64_t next = 0;
+            int x_end = (i + 1) * LIFE_WORD_BITS < g->width ? (i + 1) * LIFE_WORD_BITS : g->width;
+            for (int x = i * LIFE_WORD_BITS; x < x_end; x++) {
+                uint32_t alive = (row[i] >> (x % LIFE_WORD_BITS)) & 1, count;
+                if (rule->von_neumann) {
+                    // Upper right, lower right, upper left and lower left sides of the diamond
+                    count = left[mid + x + 2 * range + 1] - left[top + x + range]
+                          + right[bottom + x + range + 1] - right[mid + x + 2 * range + 1]
+                          - right[mid + x] + right[top + x + range + 1]
+                          - left[bottom + x + range] + left[mid + x];
+                } else {
+                    count = left[bottom + x + 2 * range + 1] - left[top + x + 2 * range + 1]
+                          - left[bottom + x] + left[top + x];
+                }
+                if (!rule->middle) count -= alive;
+                uint32_t low = alive ? rule->survival_min : rule->birth_min;
+                uint32_t high = alive ? rule->survival_max : rule->birth_max;
+                next |= (uint64_t) (count - low <= high - low) << (x % LIFE_WORD_BITS);
+            }
+            out[i] = next;
+            if (g->states) {
+                life_age_cells(life_grid_state_row(g, y), out, i, i + 1,
+                               (uint8_t) (rule->states - 1), changed);
+            }
+            // The padding bits of the current generation may hold the east halo
+            uint64_t before = row[i] & (i == words - 1 ? g->last_mask : ~(uint64_t) 0);
+            changed[i] |= out[i] != before;
+            if (g->changes.births) life_record_changes(g, y, i, before, out[i]);
+        }
+    }
+}
+
+/**
+ * @brief Computes the active tiles in tile rows [ty0, ty1) under the grid's Larger than Life
+ *        rule, using the tables of worker `job` (reserved with life_ltl_reserve()).
+ */
+
+void life_ltl_step_tiles(struct LifeGrid *g, int ty0, int ty1, int job) {
+    for (int ty = ty0; ty < ty1; ty++) {
+        if (g->tile_row_active[ty]) life_ltl_step_strip(g, ty, scratch[job].tables);
+    }
+}
@@ -0,0 +1,20 @@
+/**
+ * @file life_ltl.h
+ * @brief Internal declarations for stepping Larger than Life rules.
+ *
+ * Larger than Life rules count neighbours over a radius of up to LIFE_MAX_RANGE cells, so the
+ * bitwise adders of the 3x3 kernels do not apply. Counts come from summed-area tables instead,
+ * which cost the same per cell whatever the radius.
+ */
+
+#ifndef LIFE_LTL_H
+#define LIFE_LTL_H
+
+#include "life_engine.h" // for the grid being stepped
+#include <stdbool.h>
+
+bool life_ltl_reserve(const struct LifeGrid *g, int jobs);
+void life_ltl_step_tiles(struct LifeGrid *g, int ty0, int ty1, int job);
+void life_ltl_free(void);
+
+#endif
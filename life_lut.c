@@ -0,0 +1,165 @@
+/**
+ * @file life_lut.c
+ * @brief Lookup-table Game of Life engine advancing 2x2 blocks of cells per table lookup.
+ *
+ * The grid is processed in pairs of rows. For each pair, the 4x4 neighbourhood of every 2x2
+ * output block is gathered from four rows of the bit-packed grid into a 16-bit index, and the
+ * table returns the four new cells at once. Output blocks never straddle a word, since words
+ * hold an even number of cells, so results are assembled one whole word at a time.
+ */
+
+#include "life_lut.h" // for lookup-table engine declarations
+#include "life_kernel.h" // for change recording
+#include "thread_pool.h" // for multithreaded stepping
+#include <string.h>
+
+// Grids smaller than this many words are stepped on the calling thread only
+#define LIFE_LUT_PARALLEL_MIN_WORDS 4096
+
+/* --------------------------------------------------------------------------------------------
+ * Lookup Table
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * Next state of the central 2x2 block of every 4x4 neighbourhood. Bit `4 * y + x` of the index
+ * is cell (x, y) of the neighbourhood, (0, 0) being its top-left corner; bit `2 * y + x` of the
+ * entry is cell (x + 1, y + 1).
+ */
+static uint8_t life_lut[1 << 16];
+static bool lut_ready = false; // True once `life_lut` has been filled
+static struct LifeRule lut_rule; // Rule `life_lut` was filled for
+
+/**
+ * @brief Fills the lookup table by applying the rule to every 4x4 neighbourhood, unless it
+ *        already holds that rule.
+ */
+
+static void life_lut_build(const struct LifeRule *rule) {
+    if (lut_ready && rule->birth == lut_rule.birth && rule->survival == lut_rule.survival) return;
+    for (int index = 0; index < (1 << 16); index++) {
+        uint8_t result = 0;
+        for (int oy = 0; oy < 2; oy++) {
+            for (int ox = 0; ox < 2; ox++) {
+                int neighbours = 0;
+                for (int dy = 0; dy < 3; dy++) {
+                    for (int dx = 0; dx < 3; dx++) {
+                        if (dx == 1 && dy == 1) continue;
+                        neighbours += (index >> (4 * (oy + dy) + ox + dx)) & 1;
+                    }
+                }
+                bool alive = (index >> (4 * (oy + 1) + ox + 1)) & 1;
+                uint16_t counts = alive ? rule->survival : rule->birth;
+                if ((counts >> neighbours) & 1) result |= 1 << (2 * oy + ox);
+            }
+        }
+        life_lut[index] = result;
+    }
+    lut_rule = *rule;
+    lut_ready = true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Stepping
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Extracts the four cells from x - 1 to x + 2 of a row, for every even x of word `i`.
+ * @param row Row to read; its halo words supply the cells past either end.
+ * @param i Word index.
+ * @param nibbles Receives the 32 four-cell groups of the word.
+ */
+
+static inline void life_lut_nibbles(const uint64_t *row, int i, uint8_t *nibbles) {
+    uint64_t west = row[i - 1], c = row[i], east = row[i + 1];
+    uint64_t shifted = (c << 1) | (west >> 63); // Bit k holds cell k - 1
+    for (int k = 0; k < 31; k++) nibbles[k] = (shifted >> (2 * k)) & 0xF;
+    nibbles[31] = (uint8_t) ((c >> 61) | ((east & 1) << 3));
+}
+
+/**
+ * @brief Computes the row pairs in tile rows [ty0, ty1) into the back buffer and records which
+ *        tiles changed.
+ */
+
+static void life_lut_step_tiles(struct LifeGrid *g, int ty0, int ty1) {
+    int words = g->words;
+    for (int ty = ty0; ty < ty1; ty++) {
+        uint8_t *changed = g->tile_next_changed + (size_t) ty * words;
+        int y_end = (ty + 1) * LIFE_TILE_ROWS < g->height ? (ty + 1) * LIFE_TILE_ROWS : g->height;
+
+        // Tiles have an even number of rows, so a row pair never straddles two tiles
+        for (int y = ty * LIFE_TILE_ROWS; y < y_end; y += 2) {
+            // Rows -1 and `height` are the halo rows; the row after the bottom halo row only
+            // feeds the second row of a pair that hangs off an odd-height grid
+            const uint64_t *rows[4];
+            for (int r = 0; r < 4; r++) {
+                int ry = y - 1 + r;
+                rows[r] = ry <= g->height ? life_grid_row(g, ry) : g->zero + LIFE_ROW_OFFSET;
+            }
+            uint64_t *out0 = life_grid_back_row(g, y);
+            uint64_t *out1 = y + 1 < g->height ? life_grid_back_row(g, y + 1) : NULL;
+
+            for (int i = 0; i < words; i++) {
+                uint8_t n[4][32];
+                for (int r = 0; r < 4; r++) life_lut_nibbles(rows[r], i, n[r]);
+
+                uint64_t top = 0, bottom = 0;
+                for (int k = 0; k < 32; k++) {
+                    uint8_t block = life_lut[n[0][k] | n[1][k] << 4 | n[2][k] << 8 | n[3][k] << 12];
+                    top |= (uint64_t) (block & 3) << (2 * k);
+                    bottom |= (uint64_t) (block >> 2) << (2 * k);
+                }
+                // Cells past the right edge never come alive, and the padding bits of the
+                // current generation may hold the east halo
+                uint64_t mask = i == words - 1 ? g->last_mask : ~(uint64_t) 0;
+                top &= mask;
+                bottom &= mask;
+
+                uint64_t above = rows[1][i] & mask, below = rows[2][i] & mask;
+                out0[i] = top;
+                changed[i] |= top != above;
+                if (g->changes.births) life_record_changes(g, y, i, above, top);
+                if (out1) {
+                    out1[i] = bottom;
+                    changed[i] |= bottom != below;
+                    if (g->changes.births) life_record_changes(g, y + 1, i, below, bottom);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Thread pool job computing one horizontal band of tile rows.
+ */
+
+static void life_lut_step_band(void *ctx, int index, int count) {
+    struct LifeGrid *g = ctx;
+    int ty0 = (int) ((long long) g->tile_rows * index / count);
+    int ty1 = (int) ((long long) g->tile_rows * (index + 1) / count);
+    life_lut_step_tiles(g, ty0, ty1);
+}
+
+/**
+ * @brief Advances the grid by the given number of generations using the lookup table.
+ *
+ * Every cell is recomputed each generation; the per-tile change flags are still maintained so
+ * the bitwise engine can pick up where this one left off.
+ *
+ * @param g Grid to advance.
+ * @param generations Number of generations to advance.
+ */
+
+void life_lut_advance(struct LifeGrid *g, uint64_t generations) {
+    life_lut_build(&g->rule);
+    for (uint64_t gen = 0; gen < generations; gen++) {
+        life_grid_refresh_halo(g);
+        if ((size_t) g->words * g->height < LIFE_LUT_PARALLEL_MIN_WORDS || thread_pool_size() == 1) {
+            life_lut_step_tiles(g, 0, g->tile_rows);
+        } else {
+            thread_pool_run(life_lut_step_band, g);
+        }
+
+        life_grid_swap(g);
+    }
+}
@@ -0,0 +1,18 @@
+/**
+ * @file life_lut.h
+ * @brief Declarations for the lookup-table stepping engine.
+ *
+ * A precomputed 65536-entry table maps every 4x4 block of cells to the next state of its central
+ * 2x2 block, so a single table lookup advances four cells. Unlike the bitwise engine this needs
+ * no wide registers, which makes it a good portable baseline to benchmark against.
+ */
+
+#ifndef LIFE_LUT_H
+#define LIFE_LUT_H
+
+#include "life_engine.h" // for the grid the engine reads and writes
+#include <stdint.h>
+
+void life_lut_advance(struct LifeGrid *g, uint64_t generations);
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file life_random.c
+ * @brief Reproducible random soups, filled a packed word at a time.
+ *
+ * Random word `counter` of a seed is the splitmix64 finalizer applied to the counter scaled by
+ * an odd constant and offset by a key derived from the seed. The finalizer is a bijection with
+ * full avalanche, so consecutive counters give unrelated words, and no state is carried from
+ * one word to the next.
+ *
+ * A cell is alive with a probability of t / 2^16. Each bit of t, from the lowest set one up,
+ * combines a fresh random word into the soup word: OR-ing in a word of fair bits turns a
+ * probability p into (1 + p) / 2, AND-ing turns it into p / 2, so the bits of t are shifted in
+ * one at a time and 64 cells cost at most 16 random words (one at a density of 50%).
+ */
+
+#include "life_random.h" // for random soup declarations
+#include "thread_pool.h" // for multithreaded filling
+#include <SDL3/SDL.h> // for SDL_lround and SDL_clamp
+
+// Grids smaller than this many words are filled on the calling thread only
+#define LIFE_RANDOM_PARALLEL_MIN_WORDS 4096
+
+/**
+ * @struct LifeRandomJob
+ * @brief A soup being filled by the workers.
+ */
+
+struct LifeRandomJob {
+    struct LifeGrid *g; // Grid being filled
+    uint64_t key; // Key derived from the seed
+    uint32_t threshold; // Cells are alive with a probability of threshold / 2^16
+};
+
+/**
+ * @brief Mixes the bits of a word (the splitmix64 finalizer).
+ */
+
+static inline uint64_t life_random_mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Returns random word `counter` for a key made by life_random_mix() from a seed.
+ */
+
+static inline uint64_t life_random_keyed(uint64_t key, uint64_t counter) {
+    return life_random_mix(key + (counter + 1) * 0x9E3779B97F4A7C15ull);
+}
+
+/**
+ * @brief Returns random word `counter` of the sequence of a seed.
+ * @param seed Seed of the sequence.
+ * @param counter Index of the word in the sequence.
+ */
+
+uint64_t life_random_word(uint64_t seed, uint64_t counter) {
+    return life_random_keyed(life_random_mix(seed), counter);
+}
+
+/**
+ * @brief Thread pool job filling one horizontal band of rows. Every word only depends on its
+ *        position, so the soup does not depend on how the rows are split.
+ */
+
+static void life_random_band(void *ctx, int index, int count) {
+    const struct LifeRandomJob *job = ctx;
+    struct LifeGrid *g = job->g;
+    int y0 = (int) ((long long) g->height * index / count);
+    int y1 = (int) ((long long) g->height * (index + 1) / count);
+    // Bits of the threshold below its lowest set one would only AND zeros together
+    int lowest = 0;
+    while (lowest < LIFE_RANDOM_DENSITY_BITS && !((job->threshold >> lowest) & 1)) lowest++;
+
+    for (int y = y0; y < y1; y++) {
+        uint64_t *row = life_grid_row(g, y);
+        for (int i = 0; i < g->words; i++) {
+            uint64_t counter = ((uint64_t) y * g->words + i) * LIFE_RANDOM_DENSITY_BITS;
+            uint64_t word = 0;
+            for (int bit = lowest; bit < LIFE_RANDOM_DENSITY_BITS; bit++) {
+                uint64_t random = life_random_keyed(job->key, counter + bit);
+                word = (job->threshold >> bit) & 1 ? word | random : word & random;
+            }
+            if (job->threshold >> LIFE_RANDOM_DENSITY_BITS) word = ~(uint64_t) 0;
+            row[i] = word;
+        }
+        row[g->words - 1] &= g->last_mask;
+        if (!g->states) continue;
+        uint8_t *states = life_grid_state_row(g, y);
+        for (int x = 0; x < g->words * LIFE_WORD_BITS; x++) {
+            states[x] = (uint8_t) ((row[x / LIFE_WORD_BITS] >> (x % LIFE_WORD_BITS)) & 1);
+        }
+    }
+}
+
+/**
+ * @brief Replaces the grid with a random soup. Under a Generations rule the live cells are in
+ *        state 1 and the others in state 0.
+ * @param g Grid to fill.
+ * @param density Probability of each cell to be alive, rounded to a multiple of 2^-16.
+ * @param seed Seed of the soup; the same seed and density always give the same soup.
+ */
+
+void life_grid_randomize(struct LifeGrid *g, double density, uint64_t seed) {
+    density = SDL_clamp(density, 0.0, 1.0);
+    struct LifeRandomJob job = {
+        g, life_random_mix(seed),
+        (uint32_t) SDL_lround(density * (1 << LIFE_RANDOM_DENSITY_BITS))
+    };
+    if ((size_t) g->words * g->height < LIFE_RANDOM_PARALLEL_MIN_WORDS ||
+        thread_pool_size() == 1) {
+        life_random_band(&job, 0, 1);
+    } else {
+        thread_pool_run(life_random_band, &job);
+    }
+    life_grid_mark_all(g);
+}
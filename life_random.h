@@ -0,0 +1,21 @@
+/**
+ * @file life_random.h
+ * @brief Declarations for filling the grid with reproducible random soups.
+ *
+ * The generator is counter-based: every random word is a hash of the seed and its own index,
+ * so any word can be computed without the ones before it. Soups can therefore be filled by any
+ * number of threads in any order and still come out the same for the same seed and density.
+ */
+
+#ifndef LIFE_RANDOM_H
+#define LIFE_RANDOM_H
+
+#include "life_engine.h" // for the grid being filled
+#include <stdint.h>
+
+#define LIFE_RANDOM_DENSITY_BITS 16 // Precision of the density of a soup, in bits
+
+uint64_t life_random_word(uint64_t seed, uint64_t counter);
+void life_grid_randomize(struct LifeGrid *g, double density, uint64_t seed);
+
+#endif
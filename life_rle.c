@@ -0,0 +1,255 @@
+/**
+ * @file life_rle.c
+ * @brief Reading and writing patterns in the RLE format.
+ *
+ * Loading goes through life_engine_place(), so cells beyond the grid are kept by unbounded
+ * engines and dropped by bounded ones, and a rule given in the header is applied to the grid.
+ */
+
+#include "life_rle.h" // for RLE declarations
+#include <SDL3/SDL.h> // for SDL logging and error reporting
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LIFE_RLE_LINE_LENGTH 70 // Longest line written, as RLE readers expect
+
+/* --------------------------------------------------------------------------------------------
+ * Reading
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Loads an RLE pattern into the grid, on top of the cells already there.
+ * @param g Grid to load into.
+ * @param filename Path to RLE file.
+ * @param offset_x Plane column the left edge of the pattern is placed at.
+ * @param offset_y Plane row the top edge of the pattern is placed at.
+ * @return true if the file was read, false if it could not be opened.
+ */
+
+bool life_rle_load(struct LifeGrid *g, const char *filename, int64_t offset_x, int64_t offset_y) {
+    FILE *f = fopen(filename, "r");
+    if (!f) {
+        SDL_SetError("Error loading rle: %s", filename);
+        return false;
+    }
+    // Read the header, if present
+    char line[1024];
+    bool header_found = false;
+    while (fgets(line, sizeof(line), f)) {
+        char *p = line;
+        while (isspace((unsigned char) *p)) p++;
+        if (*p == '#') continue; // Skip comments
+        if (strstr(p, "x") && strstr(p, "=") && strstr(p, "y")) {
+            header_found = true;
+            // Switch to the pattern's rule, e.g. "x = 3, y = 3, rule = B36/S23". The rule comes
+            // last and runs to the end of the line, since Larger than Life rules contain commas
+            char *rule_text = strstr(p, "rule");
+            if (rule_text && (rule_text = strchr(rule_text, '='))) {
+                rule_text[1 + strcspn(rule_text + 1, "\r\n")] = '\0';
+                struct LifeRule rule;
+                if (!life_rule_parse(rule_text + 1, &rule) || !life_grid_set_rule(g, &rule)) {
+                    SDL_Log("Ignoring rule of %s: %s\n", filename, SDL_GetError());
+                }
+            }
+            break;
+        }
+    }
+    // Without a header the cells start on the first line
+    if (!header_found) {
+        rewind(f);
+    }
+
+    int64_t x = 0, y = 0; // Position within the pattern
+    int run = 0; // Length of the current run
+    bool done = false; // True once the end of the pattern is reached
+    while (!done && fgets(line, sizeof(line), f)) {
+        for (char *p = line; *p && !done; p++) {
+            if (isdigit((unsigned char) *p)) {
+                run = run * 10 + (*p - '0');
+                continue;
+            }
+            int count = run ? run : 1;
+            if (*p == 'o' || *p == 'O' || (*p >= 'A' && *p <= 'X')) {
+                // 'o' and 'A' are live cells, 'B' onwards the decay states of Generations rules
+                int state = *p == 'o' || *p == 'O' ? 1 : *p - 'A' + 1;
+                for (int i = 0; i < count; i++, x++) {
+                    int64_t cx = offset_x + x, cy = offset_y + y;
+                    if (state == 1) {
+                        // Cells outside the grid are kept only by unbounded engines
+                        life_engine_place(g, cx, cy, true);
+                    } else if (state < g->rule.states && cx >= 0 && cy >= 0 && cx < g->width &&
+                               cy < g->height) {
+                        // Only the bitwise engine keeps decay states, and only inside the grid
+                        life_grid_set_state(g, (int) cx, (int) cy, (uint8_t) state);
+                    }
+                }
+            } else if (*p == 'b' || *p == '.') {
+                x += count;
+            } else if (*p == '$') {
+                y += count;
+                x = 0;
+            } else if (*p == '!') {
+                done = true;
+            } else {
+                continue; // Whitespace and line breaks leave a pending run count alone
+            }
+            run = 0;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+/**
+ * @brief Reads the pattern size from the header of an RLE file.
+ * @param filename Path to RLE file.
+ * @param width Receives the pattern width.
+ * @param height Receives the pattern height.
+ * @return true if the file has a header with a valid size, false otherwise.
+ */
+
+bool life_rle_dimensions(const char *filename, int *width, int *height) {
+    FILE *f = fopen(filename, "r");
+    if (!f) {
+        SDL_SetError("Error loading rle: %s", filename);
+        return false;
+    }
+    char line[1024];
+    bool found = false;
+    while (fgets(line, sizeof(line), f)) {
+        char *p = line;
+        while (isspace((unsigned char) *p)) p++;
+        if (*p == '#' || !*p) continue; // Skip comments and blank lines
+        found = sscanf(p, "x = %d, y = %d", width, height) == 2 && *width > 0 && *height > 0;
+        break;
+    }
+    fclose(f);
+    if (!found) SDL_SetError("No pattern size in %s", filename);
+    return found;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Writing
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Appends one run to an RLE file, starting a new line before it grows too long.
+ * @param f File being written.
+ * @param run Number of cells or rows in the run.
+ * @param tag Cell state or end-of-row character.
+ * @param line_length Length of the current line, updated.
+ */
+
+static void life_rle_put_run(FILE *f, int64_t run, char tag, int *line_length) {
+    char item[32];
+    int length = run > 1 ? SDL_snprintf(item, sizeof(item), "%lld%c", (long long) run, tag)
+                         : SDL_snprintf(item, sizeof(item), "%c", tag);
+    if (*line_length + length > LIFE_RLE_LINE_LENGTH) {
+        fputc('\n', f);
+        *line_length = 0;
+    }
+    fputs(item, f);
+    *line_length += length;
+}
+
+/**
+ * @brief Saves the grid as an RLE pattern, in the states notation under a Generations rule.
+ * @param g Grid to save.
+ * @param filename Path to RLE file.
+ * @return true if the file was written, false otherwise.
+ */
+
+bool life_rle_save(const struct LifeGrid *g, const char *filename) {
+    FILE *f = fopen(filename, "w");
+    if (!f) {
+        SDL_SetError("Error saving rle: %s", filename);
+        return false;
+    }
+    char rule[LIFE_RULE_TEXT_SIZE];
+    life_rule_format(&g->rule, rule, sizeof(rule));
+    fprintf(f, "#C Generation %llu\n", (unsigned long long) g->generation);
+    fprintf(f, "x = %d, y = %d, rule = %s\n", g->width, g->height, rule);
+
+    // Dead cells at the end of a row and empty rows are only written once followed by live cells
+    int line_length = 0, rows = 0;
+    for (int y = 0; y < g->height; y++) {
+        rows = y > 0 ? rows + 1 : 0;
+        int x = 0;
+        while (x < g->width) {
+            uint8_t state = life_grid_get_state(g, x, y);
+            int run = 1;
+            while (x + run < g->width && life_grid_get_state(g, x + run, y) == state) run++;
+            if (state == 0 && x + run == g->width) break;
+            if (rows > 0) {
+                life_rle_put_run(f, rows, '$', &line_length);
+                rows = 0;
+            }
+            char tag = g->states ? (state ? (char) ('A' + state - 1) : '.') : (state ? 'o' : 'b');
+            life_rle_put_run(f, run, tag, &line_length);
+            x += run;
+        }
+    }
+    fputs("!\n", f);
+    bool ok = !ferror(f);
+    if (fclose(f) != 0) ok = false;
+    if (!ok) SDL_SetError("Error saving rle: %s", filename);
+    return ok;
+}
+
+/**
+ * @brief Saves a list of live cells as an RLE pattern cropped to their bounding box, whose
+ *        top-left corner is recorded in a `#CXRLE Pos=x,y` line as Golly does.
+ * @param cells Live cells, sorted by row and then by column, without duplicates.
+ * @param count Number of cells.
+ * @param rule Rule written in the header (Life-like, since every cell is in state 1).
+ * @param generation Generation written in the comment line.
+ * @param filename Path to RLE file.
+ * @return true if the file was written, false otherwise.
+ */
+
+bool life_rle_save_cells(const struct LifeRleCell *cells, size_t count,
+                         const struct LifeRule *rule, uint64_t generation, const char *filename) {
+    FILE *f = fopen(filename, "w");
+    if (!f) {
+        SDL_SetError("Error saving rle: %s", filename);
+        return false;
+    }
+    int64_t x0 = count ? cells[0].x : 0, x1 = x0;
+    for (size_t i = 1; i < count; i++) {
+        x0 = SDL_min(x0, cells[i].x);
+        x1 = SDL_max(x1, cells[i].x);
+    }
+    int64_t y0 = count ? cells[0].y : 0, y1 = count ? cells[count - 1].y : 0;
+    char rule_text[LIFE_RULE_TEXT_SIZE];
+    life_rule_format(rule, rule_text, sizeof(rule_text));
+    fprintf(f, "#C Generation %llu\n", (unsigned long long) generation);
+    fprintf(f, "#CXRLE Pos=%lld,%lld\n", (long long) x0, (long long) y0);
+    fprintf(f, "x = %lld, y = %lld, rule = %s\n", (long long) (count ? x1 - x0 + 1 : 0),
+            (long long) (count ? y1 - y0 + 1 : 0), rule_text);
+
+    // Runs of live cells, with the gaps before them as dead runs and row ends
+    int line_length = 0;
+    int64_t row = y0, column = x0; // Position of the next cell to write
+    for (size_t i = 0; i < count;) {
+        if (cells[i].y > row) {
+            life_rle_put_run(f, cells[i].y - row, '$', &line_length);
+            row = cells[i].y;
+            column = x0;
+        }
+        if (cells[i].x > column) life_rle_put_run(f, cells[i].x - column, 'b', &line_length);
+        size_t run = 1;
+        while (i + run < count && cells[i + run].y == row &&
+               cells[i + run].x == cells[i].x + (int64_t) run) {
+            run++;
+        }
+        life_rle_put_run(f, (int64_t) run, 'o', &line_length);
+        column = cells[i].x + (int64_t) run;
+        i += run;
+    }
+    fputs("!\n", f);
+    bool ok = !ferror(f);
+    if (fclose(f) != 0) ok = false;
+    if (!ok) SDL_SetError("Error saving rle: %s", filename);
+    return ok;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file life_rle.h
+ * @brief Declarations for reading and writing patterns in the RLE format.
+ *
+ * RLE is the run-length encoded text format used by Golly and most pattern collections: an
+ * optional `x = W, y = H, rule = R` header followed by runs of dead (`b`) and live (`o`) cells,
+ * `$` ending each row and `!` ending the pattern. Multi-state patterns use `.` for dead cells and
+ * `A`, `B`, ... for states 1, 2, ...
+ */
+
+#ifndef LIFE_RLE_H
+#define LIFE_RLE_H
+
+#include "life_engine.h" // for the grid patterns are loaded into
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @struct LifeRleCell
+ * @brief Plane coordinates of one live cell, for saving cells that are not on a grid.
+ */
+
+struct LifeRleCell {
+    int64_t x, y;
+};
+
+bool life_rle_load(struct LifeGrid *g, const char *filename, int64_t offset_x, int64_t offset_y);
+bool life_rle_dimensions(const char *filename, int *width, int *height);
+bool life_rle_save(const struct LifeGrid *g, const char *filename);
+bool life_rle_save_cells(const struct LifeRleCell *cells, size_t count,
+                         const struct LifeRule *rule, uint64_t generation, const char *filename);
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file life_simd.c
+ * @brief Scalar and SIMD row kernels for the bit-packed Game of Life engine.
+ *
+ * Every kernel computes exactly the same result; they only differ in how many words are
+ * processed per instruction. The SIMD variants are compiled with per-function target attributes
+ * so a single binary carries all of them, and life_engine.c picks the fastest one the running
+ * CPU supports.
+ */
+
+#include "life_kernel.h" // for row kernel declarations
+#include <SDL3/SDL.h> // for SDL CPU feature detection
+#include <SDL3/SDL_intrin.h> // for SIMD intrinsics and target attributes
+
+/* --------------------------------------------------------------------------------------------
+ * Scalar Kernel
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Computes the next generation of part of a row, one 64-bit word at a time.
+ *
+ * This is the portable fallback used when no SIMD instruction set is available.
+ */
+
+void life_step_row_scalar(const uint64_t *above, const uint64_t *row, const uint64_t *below,
+                          uint64_t *out, int w0, int w1, const struct LifeRuleProgram *program) {
+    uint64_t aw = above[w0 - 1], a = above[w0];
+    uint64_t cw = row[w0 - 1], c = row[w0];
+    uint64_t bw = below[w0 - 1], b = below[w0];
+
+    for (int i = w0; i < w1; i++) {
+        // Word w1 is at most the east halo word, so this never reads past the row
+        uint64_t ae = above[i + 1], ce = row[i + 1], be = below[i + 1];
+
+        out[i] = life_next_word(program, aw, a, ae, cw, c, ce, bw, b, be);
+
+        aw = a; a = ae;
+        cw = c; c = ce;
+        bw = b; b = be;
+    }
+}
+
+static bool life_scalar_supported(void) {
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * SIMD Kernels
+ * --------------------------------------------------------------------------------------------
+ * Each block instantiates life_simd_kernel.h with the vector operations of one instruction set.
+ * -------------------------------------------------------------------------------------------- */
+
+// Generic three-input helpers for instruction sets without a ternary logic instruction
+#define LIFE_GENERIC_XOR3(a, b, c) V_XOR(V_XOR(a, b), c)
+#define LIFE_GENERIC_MAJ(a, b, c) V_OR(V_AND(a, b), V_AND(V_XOR(a, b), c))
+
+#ifdef SDL_SSE2_INTRINSICS
+#define LIFE_SIMD_NAME life_step_row_sse2
+#define LIFE_SIMD_TARGET SDL_TARGETING("sse2")
+#define LIFE_SIMD_WORDS 2
+#define V __m128i
+#define V_LOAD(p) _mm_loadu_si128((const __m128i *) (p))
+#define V_STORE(p, v) _mm_storeu_si128((__m128i *) (p), v)
+#define V_SET1(x) _mm_set1_epi64x((long long) (x))
+#define V_AND _mm_and_si128
+#define V_OR _mm_or_si128
+#define V_XOR _mm_xor_si128
+#define V_ANDNOT _mm_andnot_si128
+#define V_SHL _mm_slli_epi64
+#define V_SHR _mm_srli_epi64
+#define V_XOR3 LIFE_GENERIC_XOR3
+#define V_MAJ LIFE_GENERIC_MAJ
+#include "life_simd_kernel.h"
+
+static bool life_sse2_supported(void) {
+    return SDL_HasSSE2();
+}
+#endif
+
+#ifdef SDL_AVX2_INTRINSICS
+#define LIFE_SIMD_NAME life_step_row_avx2
+#define LIFE_SIMD_TARGET SDL_TARGETING("avx2")
+#define LIFE_SIMD_WORDS 4
+#define V __m256i
+#define V_LOAD(p) _mm256_loadu_si256((const __m256i *) (p))
+#define V_STORE(p, v) _mm256_storeu_si256((__m256i *) (p), v)
+#define V_SET1(x) _mm256_set1_epi64x((long long) (x))
+#define V_AND _mm256_and_si256
+#define V_OR _mm256_or_si256
+#define V_XOR _mm256_xor_si256
+#define V_ANDNOT _mm256_andnot_si256
+#define V_SHL _mm256_slli_epi64
+#define V_SHR _mm256_srli_epi64
+#define V_XOR3 LIFE_GENERIC_XOR3
+#define V_MAJ LIFE_GENERIC_MAJ
+#include "life_simd_kernel.h"
+
+static bool life_avx2_supported(void) {
+    return SDL_HasAVX2();
+}
+#endif
+
+#ifdef SDL_AVX512F_INTRINSICS
+#define LIFE_SIMD_NAME life_step_row_avx512
+#define LIFE_SIMD_TARGET SDL_TARGETING("avx512f")
+#define LIFE_SIMD_WORDS 8
+#define V __m512i
+#define V_LOAD(p) _mm512_loadu_si512((const void *) (p))
+#define V_STORE(p, v) _mm512_storeu_si512((void *) (p), v)
+#define V_SET1(x) _mm512_set1_epi64((long long) (x))
+#define V_AND _mm512_and_si512
+#define V_OR _mm512_or_si512
+#define V_XOR _mm512_xor_si512
+#define V_ANDNOT _mm512_andnot_si512
+#define V_SHL _mm512_slli_epi64
+#define V_SHR _mm512_srli_epi64
+// vpternlogq evaluates any three-input boolean function in one instruction
+#define V_XOR3(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0x96)
+#define V_MAJ(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xE8)
+#include "life_simd_kernel.h"
+
+static bool life_avx512_supported(void) {
+    return SDL_HasAVX512F();
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------
+ * Kernel Table
+ * -------------------------------------------------------------------------------------------- */
+
+const struct LifeKernelInfo life_kernels[] = {
+    {"scalar", life_step_row_scalar, life_scalar_supported},
+#ifdef SDL_SSE2_INTRINSICS
+    {"sse2", life_step_row_sse2, life_sse2_supported},
+#endif
+#ifdef SDL_AVX2_INTRINSICS
+    {"avx2", life_step_row_avx2, life_avx2_supported},
+#endif
+#ifdef SDL_AVX512F_INTRINSICS
+    {"avx512", life_step_row_avx512, life_avx512_supported},
+#endif
+};
+
+const int life_kernel_count = sizeof(life_kernels) / sizeof(life_kernels[0]);
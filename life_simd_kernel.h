@@ -0,0 +1,124 @@
+/**
+ * @file life_simd_kernel.h
+ * @brief Vector row kernel body, instantiated once per instruction set by life_simd.c.
+ *
+ * This header has no include guard on purpose. Before including it, define:
+ * - `LIFE_SIMD_NAME` - name of the generated row kernel
+ * - `LIFE_SIMD_TARGET` - target attribute enabling the instruction set
+ * - `LIFE_SIMD_WORDS` - number of 64-bit words per vector
+ * - `V` - vector type, and the operations `V_LOAD(p)`, `V_STORE(p, v)`, `V_SET1(x)` (broadcast),
+ *   `V_AND(a, b)`, `V_OR(a, b)`, `V_XOR(a, b)`, `V_ANDNOT(a, b)` (computes ~a & b),
+ *   `V_SHL(v, n)`, `V_SHR(v, n)` (per 64-bit lane), `V_XOR3(a, b, c)` and `V_MAJ(a, b, c)`
+ *   (majority of three).
+ *
+ * All parameters are undefined again at the end of the file.
+ */
+
+#define LIFE_SIMD_PASTE2(a, b) a##b
+#define LIFE_SIMD_PASTE(a, b) LIFE_SIMD_PASTE2(a, b)
+#define LIFE_SIMD_COUNT LIFE_SIMD_PASTE(LIFE_SIMD_NAME, _count)
+
+/**
+ * @brief Vectorized equivalent of life_count_word() for the words starting at `i`.
+ *
+ * Every word is loaded three times (at offsets -1, 0 and +1) with unaligned loads so its west
+ * and east neighbour bits can be shifted in without any lane shuffles; the halo words make those
+ * loads valid at both ends of the row.
+ *
+ * @param s Receives bits 0 and 1 of the neighbour counts.
+ * @param carry Receives the three carries into bit 2 (of which at most two are set per cell).
+ * @return The current cells.
+ */
+
+LIFE_SIMD_TARGET static inline V LIFE_SIMD_COUNT(const uint64_t *above, const uint64_t *row,
+                                                 const uint64_t *below, int i, V s[2], V carry[3]) {
+    V a = V_LOAD(above + i), c = V_LOAD(row + i), b = V_LOAD(below + i);
+
+    // Align the west and east neighbours of every cell with the cell itself
+    V a_w = V_OR(V_SHL(a, 1), V_SHR(V_LOAD(above + i - 1), 63));
+    V a_e = V_OR(V_SHR(a, 1), V_SHL(V_LOAD(above + i + 1), 63));
+    V c_w = V_OR(V_SHL(c, 1), V_SHR(V_LOAD(row + i - 1), 63));
+    V c_e = V_OR(V_SHR(c, 1), V_SHL(V_LOAD(row + i + 1), 63));
+    V b_w = V_OR(V_SHL(b, 1), V_SHR(V_LOAD(below + i - 1), 63));
+    V b_e = V_OR(V_SHR(b, 1), V_SHL(V_LOAD(below + i + 1), 63));
+
+    // Per-row partial counts (2 bits each)
+    V a0 = V_XOR3(a_w, a, a_e), a1 = V_MAJ(a_w, a, a_e);
+    V c0 = V_XOR(c_w, c_e), c1 = V_AND(c_w, c_e);
+    V b0 = V_XOR3(b_w, b, b_e), b1 = V_MAJ(b_w, b, b_e);
+
+    // Bit 0 of the total and its carry
+    s[0] = V_XOR3(a0, c0, b0);
+    V k0 = V_MAJ(a0, c0, b0);
+    // Bit 1 of the total from the four weight-2 inputs
+    V t = V_XOR(a1, c1), u = V_XOR(b1, k0);
+    s[1] = V_XOR(t, u);
+    carry[0] = V_AND(a1, c1);
+    carry[1] = V_AND(b1, k0);
+    carry[2] = V_AND(t, u);
+    return c;
+}
+
+/**
+ * @brief Vectorized equivalent of life_step_row_scalar().
+ *
+ * Conway's rule gets its own loop with the shortest expression; any other rule evaluates its
+ * compiled terms. Words that do not fill a whole vector are computed with the scalar word kernel.
+ */
+
+LIFE_SIMD_TARGET void LIFE_SIMD_NAME(const uint64_t *above, const uint64_t *row,
+                                     const uint64_t *below, uint64_t *out, int w0, int w1,
+                                     const struct LifeRuleProgram *program) {
+    int i = w0;
+    V s[2], carry[3];
+
+    if (program->conway) {
+        for (; i + LIFE_SIMD_WORDS <= w1; i += LIFE_SIMD_WORDS) {
+            V c = LIFE_SIMD_COUNT(above, row, below, i, s, carry);
+            // Survival with 2 or 3 neighbours, birth with exactly 3; any carry means 4 or more
+            V crowded = V_OR(V_OR(carry[0], carry[1]), carry[2]);
+            V_STORE(out + i, V_ANDNOT(crowded, V_AND(s[1], V_OR(s[0], c))));
+        }
+    } else {
+        for (; i + LIFE_SIMD_WORDS <= w1; i += LIFE_SIMD_WORDS) {
+            V c = LIFE_SIMD_COUNT(above, row, below, i, s, carry);
+            V s2 = V_XOR3(carry[0], carry[1], carry[2]), s3 = V_MAJ(carry[0], carry[1], carry[2]);
+
+            V next = V_SET1(0);
+            for (int k = 0; k < program->term_count; k++) {
+                const struct LifeRuleTerm *term = &program->terms[k];
+                V match = V_AND(V_AND(V_XOR(s[0], V_SET1(term->count_flip[0])),
+                                      V_XOR(s[1], V_SET1(term->count_flip[1]))),
+                                V_AND(V_XOR(s2, V_SET1(term->count_flip[2])),
+                                      V_XOR(s3, V_SET1(term->count_flip[3]))));
+                V result = V_OR(V_AND(c, V_SET1(term->survives)),
+                                V_ANDNOT(c, V_SET1(term->born)));
+                next = V_OR(next, V_AND(match, result));
+            }
+            V_STORE(out + i, next);
+        }
+    }
+
+    for (; i < w1; i++) {
+        out[i] = life_next_word_at(program, above, row, below, i);
+    }
+}
+
+#undef LIFE_SIMD_PASTE2
+#undef LIFE_SIMD_PASTE
+#undef LIFE_SIMD_COUNT
+#undef LIFE_SIMD_NAME
+#undef LIFE_SIMD_TARGET
+#undef LIFE_SIMD_WORDS
+#undef V
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_AND
+#undef V_OR
+#undef V_XOR
+#undef V_ANDNOT
+#undef V_SHL
+#undef V_SHR
+#undef V_XOR3
+#undef V_MAJ
@@ -0,0 +1,20 @@
+/**
+ * @file life_temporal.h
+ * @brief Declarations for the temporally blocked stepping engine.
+ *
+ * Stepping one generation at a time streams the whole grid through memory every generation,
+ * which bounds large boards by memory bandwidth. This engine instead advances one band of rows
+ * several generations in a row while it stays in cache, so a board far larger than the cache is
+ * read and written once per block of generations.
+ */
+
+#ifndef LIFE_TEMPORAL_H
+#define LIFE_TEMPORAL_H
+
+#include "life_engine.h" // for the grid the engine reads and writes
+#include <stdint.h>
+
+void life_temporal_advance(struct LifeGrid *g, uint64_t generations);
+void life_temporal_reset(void);
+
+#endif
@@ -16,6 +16,11 @@
 #include <ctype.h>
 #include <string.h>
 #include "audio_manager.h" // for audio functionalities
+#include "life_engine.h" // for the bit-packed grid and stepping engine
+#include "life_history.h" // for undo and rewind
+#include "life_random.h" // for random soups
+#include "life_rle.h" // for reading and writing RLE patterns
+#include "triple_buffer.h" // for handing generations to the render thread
 
 /* --------------------------------------------------------------------------------------------
  * Game Configuration Constants
@@ -25,19 +30,31 @@
 #define WINDOW_TITLE "Conway's Game of Life | Playing" // Window title
 #define WINDOW_WIDTH 1050 // Window width in pixels
 #define WINDOW_HEIGHT 945 // Window height in pixels
-#define TILE_SIZE 35 // Size of each grid tile in pixels
-#define GRID_WIDTH (WINDOW_WIDTH / TILE_SIZE) // Number of tiles horizontally
-#define GRID_HEIGHT (WINDOW_HEIGHT / TILE_SIZE) // Number of tiles vertically
+#define TILE_SIZE 35 // Default size of each grid tile in pixels
+#define GRID_WIDTH (WINDOW_WIDTH / TILE_SIZE) // Default number of tiles horizontally
+#define GRID_HEIGHT (WINDOW_HEIGHT / TILE_SIZE) // Default number of tiles vertically
+#define MIN_LINE_TILE_SIZE 4 // Grid lines are only drawn between tiles at least this large
+#define LIFE_MAX_STEP_LOG2 40 // Largest step exponent selectable with the [ and ] keys
+#define FRAMES_PER_SECOND 60 // Frame rate of the game loop
+#define FRAME_NS (SDL_NS_PER_SECOND / FRAMES_PER_SECOND) // Duration of one frame
+#define DEFAULT_SPEED 10.0 // Target generations per second at startup
+#define MIN_SPEED 0.125 // Slowest target speed selectable with the DOWN key
+#define MAX_SPEED 1e15 // Target speeds from this one up run as fast as the frame rate allows
+#define MIN_SIMULATION_SHARE 0.1 // Least fraction of a frame left to the simulation at MAX_SPEED
+#define DEFAULT_DENSITY 0.5 // Fraction of live cells in the soups made with the G key
+#define DEFAULT_HISTORY_MB 256 // Memory kept for undo and rewind at startup, in MiB
+#define HISTORY_INTERVAL_NS (SDL_NS_PER_SECOND / 20) // Least time between checkpoints while playing
+#define BATCH_MARGIN 64 // Dead cells left around a batch pattern on a grid sized to it
 
 /* --------------------------------------------------------------------------------------------
- * Global Grid Arrays
+ * Global Grid
  * --------------------------------------------------------------------------------------------
- * `grid` holds the current state of the cells; `next_grid` is used for computing the next state
- * before swapping.
+ * `grid` holds the cells packed one per bit in two buffers that swap roles every generation.
+ * The current state is always read through the life_grid_* accessors. While the game runs,
+ * only the simulation thread touches it (see the Simulation Thread section).
  * -------------------------------------------------------------------------------------------- */
 
-int grid[GRID_HEIGHT][GRID_WIDTH] = {0};
-int next_grid[GRID_HEIGHT][GRID_WIDTH] = {0};
+struct LifeGrid grid = {0};
 
 /* --------------------------------------------------------------------------------------------
  * Struct Definitions
@@ -66,8 +83,43 @@ struct Game {
     bool is_running; // True if game is active
     bool is_playing; // True if simulation is running (not paused)
     bool is_music_playing; // True if background music is playing
-    int update_freq; // Simulation update delay in milliseconds (speed control)
+    double speed; // Target generations per second, or 0 to advance 2^step_log2 per frame
+    int step_log2; // Generations per frame (as a power of two) when `speed` is 0
+    double density; // Fraction of live cells in random soups
+    uint64_t seed; // Seed of the next random soup, incremented by each one
+    const struct GridView *view; // Latest generation published by the simulation thread
+    Uint64 present_ns; // Time the last SDL_RenderPresent() took
+    float tile_size; // Size of each grid tile in pixels, fitted so the whole grid is visible
     struct Color tile_color; // RGBA color for live cellsd
+    SDL_Texture *cell_texture; // The cells of the view, one texel per cell or block of cells
+    uint64_t *cell_band; // Live cells of several rows OR-ed together, for one row of texels
+    int cell_band_words; // Number of words `cell_band` holds
+    bool cell_texture_stale; // True if `cell_texture` does not show the latest view yet
+    struct Color cell_texture_color; // Tile color `cell_texture` was filled with
+};
+
+/**
+ * @struct Options
+ * @brief Settings parsed from the command line and configuration files at startup.
+ */
+
+struct Options {
+    int width; // Grid width in tiles (0 = fit the window with the default tile size)
+    int height; // Grid height in tiles (0 = fit the window with the default tile size)
+    int threads; // Simulation worker threads (0 = one per logical CPU core)
+    char engine[32]; // Stepping engine name, or empty for the default
+    double speed; // Initial target generations per second (0 = advance 2^step_log2 per frame)
+    int step_log2; // Initial step exponent (generations per frame when `speed` is 0)
+    enum LifeTopology topology; // How the grid edges connect
+    struct LifeRule rule; // Life-like rule, used only if `has_rule` is set
+    bool has_rule; // True if a rule was given (Conway's B3/S23 otherwise)
+    bool no_cycles; // True to keep computing every generation of a grid that cycles
+    double density; // Fraction of live cells in random soups
+    uint64_t seed; // Seed of the first random soup
+    int history_mb; // Memory kept for undo and rewind in MiB (0 = no history)
+    char batch[256]; // RLE pattern to run without a window, or empty to start the game
+    uint64_t generations; // Batch mode: number of generations to advance
+    char out[256]; // Batch mode: RLE file receiving the final generation, or empty
 };
 
 /**
@@ -87,6 +139,105 @@ struct PatternOptions {
     bool confirmed; // Boolean flag indicating whether the user has confirmed their choices
 };
 
+/**
+ * @struct GridView
+ * @brief A copy of one generation and the figures shown with it, made by the simulation thread
+ *        for the render thread to draw while the next generations are computed.
+ */
+
+struct GridView {
+    int width; // Grid width in cells
+    int height; // Grid height in cells
+    int words; // Words per row of `cells`
+    uint64_t *cells; // Live cells, `words` per row, with the padding bits cleared
+    uint8_t *states; // Cell states in rows of `words * 64` bytes, if `has_states` is set
+    size_t states_size; // Bytes allocated for `states`
+    bool has_states; // True under a Generations rule
+    uint8_t state_count; // Number of cell states of the rule
+    uint64_t generation; // Generation number
+    bool has_changes; // True if `births` and `deaths` are known for this generation
+    uint64_t births; // Cells born in the last generation
+    uint64_t deaths; // Cells that died in the last generation
+    uint64_t period; // Period of the cycle the grid is in, or 0
+    char rule[LIFE_RULE_TEXT_SIZE]; // Rule in text form
+    const char *engine; // Name of the stepping engine
+    double rate; // Measured generations per second
+};
+
+/**
+ * @enum CommandType
+ * @brief Requests the render thread sends to the simulation thread.
+ */
+
+enum CommandType {
+    COMMAND_QUIT, // Stop the simulation thread
+    COMMAND_PACE, // Play or pause, and set the speed
+    COMMAND_STEP, // Advance a number of generations, even while paused, a slice at a time
+    COMMAND_TOGGLE, // Toggle a cell
+    COMMAND_CLEAR, // Clear the grid
+    COMMAND_RANDOMIZE, // Fill the grid with random cells
+    COMMAND_LOAD_RLE, // Load an RLE pattern
+    COMMAND_NEXT_ENGINE, // Switch to the next stepping engine
+    COMMAND_NEXT_TOPOLOGY, // Switch to the next topology
+    COMMAND_UNDO, // Go back to the grid before the last edit
+    COMMAND_REWIND // Go back a number of generations
+};
+
+/**
+ * @struct Command
+ * @brief One request to the simulation thread; only the fields its type uses are set.
+ */
+
+struct Command {
+    enum CommandType type; // What to do
+    bool playing; // COMMAND_PACE: true to run, false to pause
+    double speed; // COMMAND_PACE: target generations per second, or 0 for a fixed step
+    int step_log2; // COMMAND_PACE: generations per frame as a power of two, if `speed` is 0
+    uint64_t generations; // COMMAND_STEP: generations to advance; COMMAND_REWIND: to go back
+    int x; // COMMAND_TOGGLE: cell column; COMMAND_LOAD_RLE: column of the pattern's left edge
+    int y; // COMMAND_TOGGLE: cell row; COMMAND_LOAD_RLE: row of the pattern's top edge
+    bool clear; // COMMAND_LOAD_RLE: clear the grid first
+    double density; // COMMAND_RANDOMIZE: fraction of live cells
+    uint64_t seed; // COMMAND_RANDOMIZE: seed of the soup
+    char filename[256]; // COMMAND_LOAD_RLE: RLE file to load
+};
+
+/**
+ * @struct Simulation
+ * @brief The simulation thread, its command queue and the generations it publishes.
+ */
+
+struct Simulation {
+    SDL_Thread *thread; // Thread advancing `grid`, or NULL when not running
+    SDL_Mutex *mutex; // Protects the command queue
+    SDL_Condition *wake; // Signalled when a command is queued
+    struct Command *queue; // Commands not taken by the simulation thread yet
+    int queued; // Number of commands in `queue`
+    int capacity; // Number of commands `queue` has room for
+    struct TripleBuffer views; // Hands the latest GridView to the render thread
+    struct GridView view_slots[3]; // The three views the triple buffer passes around
+    SDL_AtomicInt frame_us; // Time between the starts of the last two frames drawn, in µs
+    SDL_AtomicInt draw_us; // Time the last frame spent on events and drawing, in µs
+    SDL_AtomicInt present_us; // Time the last frame spent presenting, in µs
+    // Owned by the simulation thread
+    bool playing; // True while generations advance by themselves
+    double speed; // Target generations per second, or 0 to advance 2^step_log2 per frame
+    int step_log2; // Generations per frame (as a power of two) when `speed` is 0
+    double owed; // Generations due at the target speed that are not computed yet
+    uint64_t step_left; // Generations of the current fixed step or N step not computed yet
+    double ns_per_generation; // Recent cost of one generation, for sizing batches to the frame
+    double generations_per_frame; // MAX_SPEED: generations the controller allots to a slice
+    double share; // MAX_SPEED: fraction of each slice the controller lets the simulation use
+    double slice_cost; // MAX_SPEED: average cost per generation of recent slices, in ns
+    Uint64 publish_ns; // Time the last view took to copy
+    Uint64 rate_start; // Start of the interval the measured speed is averaged over
+    uint64_t rate_generations; // Generations computed since `rate_start`
+    double rate; // Measured generations per second over the last interval
+    struct LifeHistory history; // Recent generations and edits, for undo and rewind
+    Uint64 recorded_at; // When the grid was last recorded in `history`
+    Uint64 record_ns; // Time that took
+};
+
 /* --------------------------------------------------------------------------------------------
  * Utility Windows (Help, Patterns, Menus, Color Picker)
  * --------------------------------------------------------------------------------------------
@@ -173,8 +324,13 @@ void show_help_window() {
         "[G] - Randomize grid",
         "[Mouse] - Toggle cell",
         "[N] - Next generation",
-        "[UP] - Speed up simulation",
-        "[DOWN] - Slow down simulation",
+        "[LEFT] - Previous generation",
+        "[Z] - Undo last edit",
+        "[UP] - Double target speed",
+        "[DOWN] - Halve target speed",
+        "[E] - Switch stepping engine",
+        "[T] - Switch edge topology",
+        "[ / ] - Halve / double generations per frame",
         "[P] - Show Patterns menu",
         "[H] - Show this help menu",
         "[S] - Customize simulation",
@@ -184,7 +340,7 @@ void show_help_window() {
     
     int num_lines = sizeof(lines) / sizeof(lines[0]);
 
-    show_menu_window("Conway's Game of Life | Hotkeys", 600, 600, lines, num_lines);
+    show_menu_window("Conway's Game of Life | Hotkeys", 600, 780, lines, num_lines);
 }
 
 /**
@@ -244,18 +400,70 @@ bool game_init_sdl(struct Game *g) {
     return true;
 }
 
+/**
+ * @brief Allocates the simulation grid and sets up the engine as the options ask. Needs no SDL
+ *        subsystem, so batch mode shares it with the game.
+ * @param opts Command-line options to apply.
+ * @param width Grid width in cells.
+ * @param height Grid height in cells.
+ * @return true if the grid is ready, false otherwise.
+ */
+
+bool grid_new(const struct Options *opts, int width, int height) {
+    if (!life_grid_init(&grid, width, height)) {
+        SDL_Log("Failed to allocate %dx%d grid: %s\n", width, height, SDL_GetError());
+        return false;
+    }
+    SDL_Log("Using %s row kernel\n", life_engine_kernel_name());
+    life_grid_set_topology(&grid, opts -> topology);
+    if (opts -> has_rule && !life_grid_set_rule(&grid, &opts -> rule)) {
+        SDL_Log("%s\n", SDL_GetError());
+        return false;
+    }
+    // Skip whole periods once the grid settles into a still life or oscillator
+    if (!opts -> no_cycles && !life_grid_detect_cycles(&grid, true)) {
+        SDL_Log("Failed to allocate the cycle detector: %s\n", SDL_GetError());
+    }
+    // Select the stepping engine
+    if (opts -> engine[0] && !life_engine_select(opts -> engine)) {
+        SDL_Log("%s\n", SDL_GetError());
+        return false;
+    }
+    // Start the simulation worker threads
+    if (!life_engine_set_threads(opts -> threads)) {
+        SDL_Log("Failed to start worker threads, stepping on one thread: %s\n", SDL_GetError());
+    }
+    return true;
+}
+
+bool simulation_start(const struct Game *g, size_t history_bytes);
+void simulation_stop(void);
+
 /**
  * @brief Initializes the game state and audio system.
  * @param g Pointer to the Game instance.
+ * @param opts Command-line options to apply.
  * @return true if game setup is successful, false otherwise.
  */
 
 // Vanshi and Khushi
-bool game_new(struct Game *g) {
+bool game_new(struct Game *g, const struct Options *opts) {
     // Initialize SDL subsystems
     if (!game_init_sdl(g)) {
         return false;
     }
+    // Allocate the simulation grid
+    int width = opts -> width ? opts -> width : GRID_WIDTH;
+    int height = opts -> height ? opts -> height : GRID_HEIGHT;
+    if (!grid_new(opts, width, height)) {
+        return false;
+    }
+    // Shrink the tiles until the whole grid fits in the window (below a pixel for huge grids)
+    g -> tile_size = SDL_min((float) WINDOW_WIDTH / width, (float) WINDOW_HEIGHT / height);
+    // Record births and deaths each generation for the title bar
+    if (!life_grid_track_changes(&grid, true)) {
+        SDL_Log("Failed to allocate the change set, not tracking changes: %s\n", SDL_GetError());
+    }
     // Initialize audio system and start background music
     if (!init_audio_system()) {
         SDL_Log("Failed to initialize audio system: %s\n", SDL_GetError());
@@ -270,11 +478,19 @@ bool game_new(struct Game *g) {
     g -> is_running = true;
     g -> is_playing = true;
     g -> is_music_playing = true;
-    g -> update_freq = 60;
+    g -> speed = opts -> speed;
+    g -> step_log2 = opts -> step_log2;
+    g -> density = opts -> density;
+    g -> seed = opts -> seed;
     g -> tile_color.r = 255;
     g -> tile_color.g = 255;
     g -> tile_color.b = 0;
     g -> tile_color.a = 255;
+    // From here on the grid belongs to the simulation thread
+    if (!simulation_start(g, (size_t) opts -> history_mb << 20)) {
+        SDL_Log("Failed to start the simulation thread: %s\n", SDL_GetError());
+        return false;
+    }
     return true;
 }
 
@@ -285,6 +501,13 @@ bool game_new(struct Game *g) {
 
 // Vanshi and Khushi
 void game_free(struct Game *g) {
+    if (g -> cell_texture) {
+        SDL_DestroyTexture(g -> cell_texture);
+        g -> cell_texture = NULL;
+    }
+    SDL_free(g -> cell_band);
+    g -> cell_band = NULL;
+    g -> cell_band_words = 0;
     if (g -> renderer) {
         SDL_DestroyRenderer(g -> renderer);
         g -> renderer = NULL;
@@ -295,6 +518,9 @@ void game_free(struct Game *g) {
     }
     stop_background_music();
     shutdown_audio_system();
+    simulation_stop();
+    life_engine_shutdown();
+    life_grid_free(&grid);
     SDL_Quit();
 }
 
@@ -304,75 +530,63 @@ void game_free(struct Game *g) {
 
 /**
  * @brief Randomizes the grid with live and dead cells.
+ *
+ * Whole words of cells are filled at once, split across the worker threads on large grids,
+ * and the soup only depends on the seed and density (see life_random.c).
+ *
+ * @param density Fraction of live cells.
+ * @param seed Seed of the soup.
  */
 
 // Het and Virat
-void grid_randomize() {
-    for (int y = 0; y < GRID_HEIGHT; y++) {
-        for (int x = 0; x < GRID_WIDTH; x++) {
-            grid[y][x] = rand() % 2; // Randomly assign 0 or 1
-        }
-    }
+void grid_randomize(double density, uint64_t seed) {
+    life_grid_randomize(&grid, density, seed);
+    SDL_Log("Random soup with seed %llu at density %g\n", (unsigned long long) seed, density);
 }
 
 /**
- * @brief Counts the number of live neighbours for a given cell.
- * @param y Y-coordinate of the cell.
- * @param x X-coordinate of the cell.
- * @return Number of live neighbouring cells.
+ * @brief Computes and applies the next generations of the grid based on Conway's rules.
+ * 
+ * The work is done by the selected engine: the bit-packed engine evaluates 64 cells per word
+ * operation using the widest SIMD kernel the CPU supports, while HashLife jumps ahead by whole
+ * powers of two at once (see life_engine.c and hashlife.c).
+ * 
+ * @param generations Number of generations to advance.
  */
 
 // Prateek and Hunar
-int count_neighbours(int y, int x) {
-    int count = 0;
-    for (int dy = -1; dy <= 1; dy++) {
-        if (y+dy < 0 || y+dy >= GRID_HEIGHT) continue; // Boundary check
-        for (int dx = -1; dx <= 1; dx++) {
-            if (x+dx < 0 || x+dx >= GRID_WIDTH) continue; // Boundary check
-            if (dx == 0 && dy == 0) continue; // Skip the cell itself
-            count += grid[y+dy][x+dx];
-            
-        }
-    }
-    return count;
+void update_grid(uint64_t generations) {
+    life_engine_advance(&grid, generations);
 }
 
 /**
- * @brief Computes and applies the next generation of the grid based on Conway's rules.
+ * @brief Switches to the next available stepping engine.
  */
 
-// Prateek and Hunar
-void update_grid() {
-    for (int y = 0; y < GRID_HEIGHT; y++) {
-        for (int x = 0; x < GRID_WIDTH; x++) {
-            int neighbours = count_neighbours(y,x);
-            if (grid[y][x]) {
-                next_grid[y][x] = (neighbours == 2 || neighbours == 3); // Survival
-            } else {
-                next_grid[y][x] = (neighbours == 3); // Birth
-            }
-        }
-    }
+void cycle_engine() {
+    const struct LifeEngine *current = life_engine_current();
+    int next = (int) (current - life_engines + 1) % life_engine_count;
+    life_engine_select(life_engines[next].name);
+    SDL_Log("Switched to %s engine\n", life_engines[next].name);
+}
 
-    // Copy the next grid to the current grid
-    for (int y = 0; y < GRID_HEIGHT; y++) {
-        for (int x = 0; x < GRID_WIDTH; x++) {
-            grid[y][x] = next_grid[y][x];
-        }
-    }
+/**
+ * @brief Switches to the next grid topology (dead border, torus, Klein bottle).
+ */
+
+void cycle_topology() {
+    enum LifeTopology next = (enum LifeTopology) ((grid.topology + 1) % LIFE_TOPOLOGY_COUNT);
+    life_grid_set_topology(&grid, next);
+    SDL_Log("Switched to %s topology\n", life_topology_names[next]);
 }
 
 /**
- * @brief Clears all live cells from the grid.
+ * @brief Clears all live cells from the grid (and from the off-screen universe, if any).
  */
 
 // Het and Virat
 void clear_screen() {
-    for (int y = 0; y < GRID_HEIGHT; y++) {
-        for (int x = 0; x < GRID_WIDTH; x++) {
-            grid[y][x] = 0;
-        }
-    }
+    life_engine_clear(&grid);
 }
 
 /* --------------------------------------------------------------------------------------------
@@ -385,87 +599,457 @@ void clear_screen() {
  * @param offset_y Y-offset to apply when drawing the pattern.
  * @param offset_x X-offset to apply when drawing the pattern.
  * @param clear_before Whether to clear the grid before loading.
+ * @return true if the file was read, false if it could not be opened.
  */
 
 // Harmit and Yuvraj
-void load_rle(const char* filename, int offset_y, int offset_x, bool clear_before) {
-    FILE *f = fopen(filename, "r");
-    // Check if file opened successfully
-    if (!f) {
-        fprintf(stderr, "Error loading rle: %s\n", filename);
+bool load_rle(const char* filename, int offset_y, int offset_x, bool clear_before) {
+    if (clear_before) {
+        clear_screen();
+    }
+    if (!life_rle_load(&grid, filename, offset_x, offset_y)) {
+        fprintf(stderr, "%s\n", SDL_GetError());
+        return false;
+    }
+    fprintf(stdout, "Loaded RLE: '%s'\n", filename);
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Simulation Thread
+ * --------------------------------------------------------------------------------------------
+ * While the game runs, `grid` belongs to a thread of its own, so that neither an expensive
+ * generation nor a slow frame holds up the other. The render thread never touches the grid:
+ * edits reach the simulation as commands in a queue, and finished generations come back as
+ * GridView copies through a lock-free triple buffer, of which the render thread always draws
+ * the latest. The simulation thread works in slices of one frame, publishing at most one view
+ * per slice. It also keeps the history behind undo and rewind, recording the grid before every
+ * edit and every few slices while playing.
+ * -------------------------------------------------------------------------------------------- */
+
+static struct Simulation sim = {0}; // The simulation thread, started by game_new()
+
+/**
+ * @brief Copies the current generation and its figures into a view.
+ * @return true on success, false if the states could not be allocated.
+ */
+
+static bool view_fill(struct GridView *v) {
+    v->width = grid.width;
+    v->height = grid.height;
+    v->words = grid.words;
+    for (int y = 0; y < grid.height; y++) {
+        uint64_t *row = v->cells + (size_t) y * grid.words;
+        memcpy(row, life_grid_row(&grid, y), (size_t) grid.words * sizeof(uint64_t));
+        // The padding bits may hold the east halo
+        row[grid.words - 1] &= grid.last_mask;
+    }
+    v->has_states = grid.states != NULL;
+    if (grid.states) {
+        size_t size = (size_t) grid.words * LIFE_WORD_BITS * grid.height;
+        if (v->states_size < size) {
+            uint8_t *states = SDL_realloc(v->states, size);
+            if (!states) return false;
+            v->states = states;
+            v->states_size = size;
+        }
+        memcpy(v->states, grid.states, size);
+    }
+    v->state_count = grid.rule.states;
+    v->generation = grid.generation;
+    v->has_changes = grid.changes.valid;
+    v->births = grid.changes.birth_count;
+    v->deaths = grid.changes.death_count;
+    v->period = life_grid_cycle_period(&grid);
+    life_rule_format(&grid.rule, v->rule, sizeof(v->rule));
+    v->engine = life_engine_current() -> name;
+    v->rate = sim.rate;
+    return true;
+}
+
+/**
+ * @brief Publishes the current generation to the render thread.
+ */
+
+static void simulation_publish(void) {
+    Uint64 start = SDL_GetTicksNS();
+    if (!view_fill(triple_buffer_back(&sim.views))) {
+        SDL_Log("Failed to copy the grid for drawing: %s\n", SDL_GetError());
         return;
     }
-    // Read header to get pattern dimensions (if present)
-    char line[1024];
-    int pattern_w = -1, pattern_h = -1;
-    bool header_found = false;
-
-    while (fgets(line, sizeof(line), f)) {
-        // Trim whitespace
-        char *p = line;
-        while (isspace((unsigned char) *p)) p++;
-        if (*p == '#') continue; // Skip comments
-        // Look for dimension line
-        if (strstr(p, "x") && strstr(p, "=") && strstr(p, "y")) {
-            header_found = true;
-            if (sscanf(p, "x = %d, y = %d", &pattern_w, &pattern_h) < 2) {
-                sscanf(p, "x = %d, y = %d", &pattern_w, &pattern_h);
+    triple_buffer_publish(&sim.views);
+    sim.publish_ns = SDL_GetTicksNS() - start;
+}
+
+/**
+ * @brief Picks the generations of the next slice at MAX_SPEED from what the last one cost.
+ *
+ * The simulation may use a share of each frame, less the time the view takes to copy. The share
+ * shrinks while frames are drawn late or drawing and presenting take most of a frame, since the
+ * simulation competes with the render thread for cores and memory bandwidth, and creeps back up
+ * once they are on time again. The generations that fit the share at the measured cost per
+ * generation become the new target: the count follows a busier board down by halving the
+ * distance every slice, and a calmer one up at most twofold per slice, so the speed settles
+ * at the fastest the board sustains without jumping around.
+ *
+ * @param done Generations computed in the last slice.
+ * @param step_ns Time they took.
+ */
+
+static void simulation_control(uint64_t done, Uint64 step_ns) {
+    double frame_ns = SDL_GetAtomicInt(&sim.frame_us) * 1000.0;
+    double render_ns = SDL_GetAtomicInt(&sim.draw_us) * 1000.0 +
+                       SDL_GetAtomicInt(&sim.present_us) * 1000.0;
+    if (frame_ns > FRAME_NS * 1.1 || render_ns > FRAME_NS * 0.8) {
+        sim.share = SDL_max(sim.share * 0.8, MIN_SIMULATION_SHARE);
+    } else {
+        sim.share = SDL_min(sim.share + 0.02, 1.0);
+    }
+    if (done == 0 || step_ns == 0) return;
+    // Smooth the cost over slices, which vary with the batches they were split into
+    double cost = (double) step_ns / (double) done;
+    sim.slice_cost = sim.slice_cost > 0 ? 0.75 * sim.slice_cost + 0.25 * cost : cost;
+
+    double budget = SDL_max(sim.share * FRAME_NS - (double) sim.publish_ns,
+                            MIN_SIMULATION_SHARE * FRAME_NS);
+    double target = budget / sim.slice_cost;
+    double current = sim.generations_per_frame;
+    current = target > current ? SDL_min(target, 2 * current) : current + (target - current) / 2;
+    sim.generations_per_frame = SDL_max(current, 1.0);
+}
+
+/**
+ * @brief Computes up to `due` generations in batches sized from the measured cost of a
+ *        generation, stopping once the deadline has passed.
+ *
+ * A memoizing engine (HashLife) is instead handed the largest power of two left in one call:
+ * it computes that in about as long as any smaller power, from results cached for that very
+ * step, while a ramp of batches would split each into several powers and evict those results.
+ *
+ * @return Number of generations computed.
+ */
+
+static uint64_t simulation_batches(uint64_t due, Uint64 deadline) {
+    uint64_t done = 0;
+    while (done < due) {
+        Uint64 start = SDL_GetTicksNS();
+        if (start >= deadline) break;
+        uint64_t batch;
+        if (life_engine_for_grid(&grid) -> memoized) {
+            batch = (uint64_t) 1 << (63 - __builtin_clzll(due - done));
+        } else {
+            // Batches at most double, so that a cost measured on a cheap grid (say, one whose
+            // periods were being skipped) is checked before it is trusted with a long batch
+            batch = SDL_min(2 * done + 1, due - done);
+            if (sim.ns_per_generation > 0) {
+                double fit = (double) (deadline - start) / sim.ns_per_generation;
+                if (fit < (double) batch) batch = fit < 1 ? 1 : (uint64_t) fit;
             }
-            break;
         }
+        update_grid(batch);
+        double cost = (double) (SDL_GetTicksNS() - start) / (double) batch;
+        sim.ns_per_generation = sim.ns_per_generation > 0 ? (sim.ns_per_generation + cost) / 2
+                                                          : cost;
+        done += batch;
     }
-    // If no header found, rewind to start of the file
-    if (!header_found) {
-        rewind(f);
+    return done;
+}
+
+/**
+ * @brief Advances the grid by the generations due this slice.
+ *
+ * A fixed step of 2^step_log2 generations per frame, like a step asked for with the N key, is
+ * computed in batches until the slice is over; what is left of it carries on over the next
+ * slices, so even a step of 2^40 generations on the bitwise engine never keeps commands
+ * waiting longer than a batch. With a target speed, the generations due since the last slice
+ * are computed the same way; at MAX_SPEED the generations and the time allowed come from
+ * simulation_control() instead. Generations due at a speed that do not fit are dropped rather
+ * than carried over, so a target beyond the machine's reach runs as fast as it can without
+ * the backlog ever growing.
+ *
+ * @param slice_start When the slice started.
+ * @param elapsed_ns Time since the previous slice started.
+ */
+
+static void simulation_advance(Uint64 slice_start, Uint64 elapsed_ns) {
+    uint64_t due, done;
+    if (sim.step_left > 0 || sim.speed == 0) {
+        if (sim.step_left == 0) sim.step_left = (uint64_t) 1 << sim.step_log2;
+        // The generation counter must not wrap
+        sim.step_left = SDL_min(sim.step_left, UINT64_MAX - grid.generation);
+        done = simulation_batches(sim.step_left, slice_start + FRAME_NS);
+        sim.step_left -= done;
+    } else {
+        bool full_speed = sim.speed >= MAX_SPEED;
+        Uint64 deadline = slice_start + FRAME_NS;
+        if (full_speed) {
+            uint64_t remaining = UINT64_MAX - grid.generation;
+            due = sim.generations_per_frame < (double) remaining
+                      ? (uint64_t) sim.generations_per_frame : remaining;
+            deadline = slice_start + (Uint64) (sim.share * FRAME_NS);
+        } else {
+            sim.owed += sim.speed * (double) elapsed_ns / SDL_NS_PER_SECOND;
+            due = (uint64_t) sim.owed;
+        }
+        Uint64 step_start = SDL_GetTicksNS();
+        done = simulation_batches(due, deadline);
+        sim.owed = done < due ? 0 : sim.owed - (double) done;
+        if (full_speed) simulation_control(done, SDL_GetTicksNS() - step_start);
     }
 
-    if (clear_before) {
-        clear_screen();
+    // Average the speed actually reached over intervals of half a second
+    sim.rate_generations += done;
+    Uint64 now = SDL_GetTicksNS();
+    if (now - sim.rate_start >= SDL_NS_PER_SECOND / 2) {
+        double seconds = (double) (now - sim.rate_start) / SDL_NS_PER_SECOND;
+        sim.rate = (double) sim.rate_generations / seconds;
+        sim.rate_start = now;
+        sim.rate_generations = 0;
     }
+}
 
-    // Parse RLE data
-    int cur_x = 0, cur_y = 0; // Current position in the grid
-    int run = 0; // Length of current run
-    bool done = false; // Flag to indicate end of pattern
-
-    // Read RLE data
-    while (!done && fgets(line, sizeof(line), f)) {
-        char *p = line;
-        while (*p) {
-            if (isdigit((unsigned char) *p)) { // Run length
-                run = run * 10 + (*p - '0');
-            } else if (*p == 'o' || *p == 'O') { // Live cells
-                if (run == 0) run = 1;
-                for (int i = 0; i < run; i++) {
-                    int gx = offset_x + cur_x;
-                    int gy = offset_y + cur_y;
-                    // Set cell to alive if within bounds
-                    if (gx >= 0 && gx < GRID_WIDTH && gy >= 0 && gy < GRID_HEIGHT) {
-                        grid[gy][gx] = 1;
-                    }
-                    cur_x++; // Move to next cell
-                }
-                run = 0; // Reset run length
-            } else if (*p == 'b' || *p == '.') { // Dead cells
-                if (run == 0) run = 1;
-                cur_x += run; // Skip dead cells
-                run = 0; // Reset run length
-            } else if (*p == '$') { // New line
-                if (run == 0) run = 1;
-                cur_y += run; // Move down by run lines
-                cur_x = 0; // Reset to start of line
-                run = 0; // Reset run length
-            } else if (*p == '!') { // End of pattern
-                done = true;
-                break;
+/**
+ * @brief Records the grid in the history. A history that cannot take the grid is given up
+ *        rather than tried again every slice.
+ * @param edit True if the grid is about to be edited, so undo comes back to it.
+ */
+
+static void simulation_record(bool edit) {
+    Uint64 start = SDL_GetTicksNS();
+    if (!life_history_record(&sim.history, &grid, edit)) {
+        SDL_Log("Undo and rewind disabled: %s\n", SDL_GetError());
+        life_history_free(&sim.history);
+    }
+    sim.recorded_at = SDL_GetTicksNS();
+    sim.record_ns = sim.recorded_at - start;
+}
+
+/**
+ * @brief Tells whether a command changes the cells on the spot (steps only do so later).
+ */
+
+static bool command_edits(const struct Command *c) {
+    return c->type == COMMAND_TOGGLE || c->type == COMMAND_CLEAR ||
+           c->type == COMMAND_RANDOMIZE || c->type == COMMAND_LOAD_RLE;
+}
+
+/**
+ * @brief Carries out one command on the simulation thread.
+ * @return false if the command stops the thread, true otherwise.
+ */
+
+static bool simulation_apply(const struct Command *c) {
+    // Keep the grid as it was before an edit, to undo it
+    if (command_edits(c) || c->type == COMMAND_STEP) simulation_record(true);
+    switch (c->type) {
+        case COMMAND_QUIT:
+            return false;
+        case COMMAND_PACE:
+            if (c->speed != sim.speed || !c->playing) sim.owed = 0;
+            // A new pace replaces what is left of a step, and pausing stops a long one
+            sim.step_left = 0;
+            sim.playing = c->playing;
+            sim.speed = c->speed;
+            sim.step_log2 = c->step_log2;
+            if (!sim.playing) sim.rate = 0;
+            sim.rate_start = SDL_GetTicksNS();
+            sim.rate_generations = 0;
+            break;
+        case COMMAND_STEP:
+            sim.step_left += c->generations;
+            break;
+        case COMMAND_TOGGLE:
+            life_grid_toggle(&grid, c->x, c->y);
+            break;
+        case COMMAND_CLEAR:
+            clear_screen();
+            break;
+        case COMMAND_RANDOMIZE:
+            grid_randomize(c->density, c->seed);
+            break;
+        case COMMAND_LOAD_RLE:
+            load_rle(c->filename, c->y, c->x, c->clear);
+            break;
+        case COMMAND_NEXT_ENGINE:
+            cycle_engine();
+            break;
+        case COMMAND_NEXT_TOPOLOGY:
+            cycle_topology();
+            break;
+        case COMMAND_UNDO:
+            if (!life_history_undo(&sim.history, &grid)) SDL_Log("%s\n", SDL_GetError());
+            break;
+        case COMMAND_REWIND: {
+            uint64_t target = grid.generation - SDL_min(c->generations, grid.generation);
+            if (!life_history_rewind(&sim.history, &grid, target)) {
+                SDL_Log("%s\n", SDL_GetError());
             }
-            p++; // Move to next character
+            break;
         }
     }
-    
-    fclose(f);
-    fprintf(stdout, "Loaded RLE: '%s'\n", filename);
+    return true;
+}
+
+/**
+ * @brief Body of the simulation thread: takes the queued commands, advances the grid and
+ *        publishes the result, once per slice, until told to quit.
+ */
+
+static int simulation_thread(void *data) {
+    (void) data;
+    struct Command *commands = NULL; // The queue taken over from the render thread
+    int capacity = 0;
+    Uint64 slice_start = SDL_GetTicksNS();
+    sim.rate_start = slice_start;
+    bool running = true;
+
+    while (running) {
+        Uint64 now = SDL_GetTicksNS(), elapsed = now - slice_start;
+        slice_start = now;
+
+        // Swap queues, so the render thread never waits while commands are carried out
+        SDL_LockMutex(sim.mutex);
+        struct Command *taken = sim.queue;
+        int count = sim.queued, taken_capacity = sim.capacity;
+        sim.queue = commands;
+        sim.capacity = capacity;
+        sim.queued = 0;
+        SDL_UnlockMutex(sim.mutex);
+        commands = taken;
+        capacity = taken_capacity;
+        bool edited = false;
+        for (int i = 0; i < count && running; i++) {
+            running = simulation_apply(&commands[i]);
+            edited |= command_edits(&commands[i]);
+        }
+        if (!running) break;
+        // Also keep the grid as edited, for rewinding to the generations before the next edit
+        if (edited) simulation_record(false);
+
+        uint64_t generation = grid.generation;
+        double rate = sim.rate;
+        bool busy = sim.playing || sim.step_left > 0;
+        if (busy) simulation_advance(slice_start, elapsed);
+        // Checkpoints that take long to encode (huge busy grids) are spaced further apart
+        Uint64 interval = SDL_max(HISTORY_INTERVAL_NS, 10 * sim.record_ns);
+        if (grid.generation != generation && SDL_GetTicksNS() - sim.recorded_at >= interval) {
+            simulation_record(false);
+        }
+        if (count > 0 || grid.generation != generation || sim.rate != rate) simulation_publish();
+
+        // Wait out the rest of the slice, or until a command arrives. Paused with no step left,
+        // there is nothing to do until then
+        SDL_LockMutex(sim.mutex);
+        Uint64 end = slice_start + FRAME_NS, current = SDL_GetTicksNS();
+        busy = sim.playing || sim.step_left > 0;
+        if (!sim.queued && (!busy || current < end)) {
+            Sint32 timeout_ms = busy ? (Sint32) ((end - current + 999999) / 1000000) : -1;
+            SDL_WaitConditionTimeout(sim.wake, sim.mutex, timeout_ms);
+        }
+        SDL_UnlockMutex(sim.mutex);
+    }
+    SDL_free(commands);
+    return 0;
+}
+
+/**
+ * @brief Queues a command for the simulation thread. Called by the render thread only.
+ * @return true if the command was queued, false if memory ran out.
+ */
+
+bool simulation_post(const struct Command *c) {
+    SDL_LockMutex(sim.mutex);
+    if (sim.queued == sim.capacity) {
+        int capacity = sim.capacity ? sim.capacity * 2 : 16;
+        struct Command *queue = SDL_realloc(sim.queue, (size_t) capacity * sizeof(*queue));
+        if (!queue) {
+            SDL_UnlockMutex(sim.mutex);
+            SDL_Log("Dropping a command to the simulation: %s\n", SDL_GetError());
+            return false;
+        }
+        sim.queue = queue;
+        sim.capacity = capacity;
+    }
+    sim.queue[sim.queued++] = *c;
+    SDL_SignalCondition(sim.wake);
+    SDL_UnlockMutex(sim.mutex);
+    return true;
+}
+
+/**
+ * @brief Tells the simulation thread how long the last frame took, for simulation_control().
+ *        Called by the render thread once per frame.
+ * @param frame_ns Time between the starts of the last two frames.
+ * @param draw_ns Time the last frame spent on events and drawing.
+ * @param present_ns Time the last frame spent presenting.
+ */
+
+void simulation_report_frame(Uint64 frame_ns, Uint64 draw_ns, Uint64 present_ns) {
+    SDL_SetAtomicInt(&sim.frame_us, (int) SDL_min(frame_ns / 1000, SDL_MAX_SINT32));
+    SDL_SetAtomicInt(&sim.draw_us, (int) SDL_min(draw_ns / 1000, SDL_MAX_SINT32));
+    SDL_SetAtomicInt(&sim.present_us, (int) SDL_min(present_ns / 1000, SDL_MAX_SINT32));
+}
+
+/**
+ * @brief Sends the game's play state and speed to the simulation thread.
+ * @param g Pointer to the game instance.
+ */
+
+void simulation_pace(const struct Game *g) {
+    struct Command c = {.type = COMMAND_PACE, .playing = g->is_playing, .speed = g->speed,
+                        .step_log2 = g->step_log2};
+    simulation_post(&c);
+}
+
+/**
+ * @brief Starts the simulation thread on the grid, with a first view published for drawing.
+ * @param g Pointer to the game instance, whose play state and speed the simulation starts with.
+ * @param history_bytes Memory kept for undo and rewind, or 0 for none.
+ * @return true if the thread is running, false otherwise.
+ */
+
+bool simulation_start(const struct Game *g, size_t history_bytes) {
+    sim.mutex = SDL_CreateMutex();
+    sim.wake = SDL_CreateCondition();
+    if (!sim.mutex || !sim.wake) return false;
+    for (int i = 0; i < 3; i++) {
+        struct GridView *v = &sim.view_slots[i];
+        v->cells = SDL_malloc((size_t) grid.words * grid.height * sizeof(uint64_t));
+        if (!v->cells) return false;
+    }
+    triple_buffer_init(&sim.views, &sim.view_slots[0], &sim.view_slots[1], &sim.view_slots[2]);
+    sim.playing = g->is_playing;
+    sim.speed = g->speed;
+    sim.step_log2 = g->step_log2;
+    sim.generations_per_frame = 1;
+    sim.share = 1;
+    life_history_init(&sim.history, history_bytes);
+    simulation_publish();
+
+    sim.thread = SDL_CreateThread(simulation_thread, "simulation", NULL);
+    return sim.thread != NULL;
+}
+
+/**
+ * @brief Stops the simulation thread, after which the grid may be used directly again, and
+ *        frees its queue, views and history.
+ */
 
+void simulation_stop(void) {
+    if (sim.thread) {
+        struct Command quit = {.type = COMMAND_QUIT};
+        simulation_post(&quit);
+        SDL_WaitThread(sim.thread, NULL);
+    }
+    if (sim.wake) SDL_DestroyCondition(sim.wake);
+    if (sim.mutex) SDL_DestroyMutex(sim.mutex);
+    for (int i = 0; i < 3; i++) {
+        SDL_free(sim.view_slots[i].cells);
+        SDL_free(sim.view_slots[i].states);
+    }
+    SDL_free(sim.queue);
+    life_history_free(&sim.history);
+    memset(&sim, 0, sizeof(sim));
 }
 
 /* --------------------------------------------------------------------------------------------
@@ -841,6 +1425,10 @@ void draw_button(SDL_Renderer *ren, TTF_Font *font, SDL_FRect rect, const char *
  * Upon confirmation, the pattern specified by the given RLE file is loaded onto the grid using
  * the @ref load_rle() function with the selected options.
  * 
+ * The offsets stop where the pattern's bounding box reaches the right and bottom edges of the
+ * grid, so the whole pattern always lands on it.
+ * 
+ * @param g Game whose grid the pattern is loaded onto.
  * @param filename The file path to the RLE pattern to be loaded.
  * @param pattern_name The display name of the pattern, shown in the customization window title.
  * 
@@ -851,9 +1439,13 @@ void draw_button(SDL_Renderer *ren, TTF_Font *font, SDL_FRect rect, const char *
  */
 
 // Vanshi and Khushi, Harmit and Yuvraj
-void customize_preloaded_pattern(const char* filename, char pattern_name[]) {
+void customize_preloaded_pattern(const struct Game *g, const char* filename, char pattern_name[]) {
     // Initialize pattern options with default values
     struct PatternOptions opts = {0, 0, false, false}; 
+    int pattern_w = 0, pattern_h = 0;
+    life_rle_dimensions(filename, &pattern_w, &pattern_h);
+    int max_x = SDL_max(g -> view -> width - pattern_w, 0);
+    int max_y = SDL_max(g -> view -> height - pattern_h, 0);
 
     // Initialize TTF for text rendering
     if (TTF_Init() == -1) {
@@ -885,7 +1477,7 @@ void customize_preloaded_pattern(const char* filename, char pattern_name[]) {
                 int mx = e.button.x;
                 int my = e.button.y;
                 // Increase X offset
-                if (mx > 250 && mx < 270 && my > 80 && my < 100 && opts.offset_x < 29) {
+                if (mx > 250 && mx < 270 && my > 80 && my < 100 && opts.offset_x < max_x) {
                     opts.offset_x++;
                 }
                 // Decrease X offset
@@ -893,7 +1485,7 @@ void customize_preloaded_pattern(const char* filename, char pattern_name[]) {
                     opts.offset_x--;
                 }
                 // Increase Y offset
-                if (mx > 250 && mx < 270 && my > 120 && my < 140 && opts.offset_y < 26) {
+                if (mx > 250 && mx < 270 && my > 120 && my < 140 && opts.offset_y < max_y) {
                     opts.offset_y++;
                 }
                 // Decrease Y offset
@@ -976,7 +1568,10 @@ void customize_preloaded_pattern(const char* filename, char pattern_name[]) {
     // Load the pattern with the selected options if confirmed
     if (opts.confirmed) {
         printf("Loading pattern...\n");
-        load_rle(filename, opts.offset_y, opts.offset_x, opts.clear);
+        struct Command load = {.type = COMMAND_LOAD_RLE, .x = opts.offset_x, .y = opts.offset_y,
+                               .clear = opts.clear};
+        SDL_strlcpy(load.filename, filename, sizeof(load.filename));
+        simulation_post(&load);
     }
 
 }
@@ -985,6 +1580,19 @@ void customize_preloaded_pattern(const char* filename, char pattern_name[]) {
  * Event Handling and Input
  * -------------------------------------------------------------------------------------------- */
 
+/**
+ * @brief Doubles or halves the target speed. Coming from a fixed step per frame, the speed
+ *        starts from the one that step ran at.
+ * @param g Pointer to the game instance.
+ * @param faster True to double the speed, false to halve it.
+ */
+
+void change_speed(struct Game *g, bool faster) {
+    if (g->speed == 0) g->speed = FRAMES_PER_SECOND * SDL_pow(2, g->step_log2);
+    g->speed = faster ? SDL_min(g->speed * 2, MAX_SPEED) : SDL_max(g->speed / 2, MIN_SPEED);
+    simulation_pace(g);
+}
+
 /**
  * @brief Handles all SDL input events and updates the game state accordingly.
  * 
@@ -998,13 +1606,19 @@ void customize_preloaded_pattern(const char* filename, char pattern_name[]) {
  * - **ESC** - Exits the game.
  * - **SPACE** - Toggles between play and pause mode; pauses/resumes background music.
  * - **C** - Clears the grid, pauses the game, and plays a "clear" sound.
- * - **G** - Randomizes the grid pattern and plays a "randomization" sound.
+ * - **G** - Fills the grid with a random soup of the configured density, each press with the
+ *   next seed, and plays a "randomization" sound.
  * - **N** - Advances the simulation by one generation when paused.
  * - **H** - Displays the help window with list of hotkeys.
  * - **P** - Opens the preloaded patterns menu.
  * - **S** - Opens the customization menu for tile colors.
  * - **1, 2, 3** - Loads  predefined patterns (Glider, Blinker, or Gospel Glider Gun).
- * - **UP / DOWN** - Adjusts the update frequency (simulation speed).
+ * - **UP / DOWN** - Doubles or halves the target speed in generations per second.
+ * - **E** - Switches to the next stepping engine (bitwise or HashLife).
+ * - **T** - Switches the edge topology (dead border, torus or Klein bottle).
+ * - **[ / ]** - Halves or doubles the number of generations advanced per frame.
+ * - **Z** - Undoes the last edit (clear, randomize, pattern, cell toggle or step).
+ * - **LEFT** - Pauses and goes back as many generations as N advances.
  * - **Mouse Click** - Toggles the state of the clicked cell and plays a toggle sound.
  * 
  * @note This function ensures responsive interaction by handling both keyboard and mouse inputs
@@ -1025,6 +1639,7 @@ void game_events(struct Game *g) {
                         break;
                     case SDL_SCANCODE_SPACE:
                         g->is_playing = !g->is_playing;
+                        simulation_pace(g);
                         if (g->is_playing) {
                             if (g->is_music_playing) {
                                 resume_background_music();
@@ -1034,18 +1649,21 @@ void game_events(struct Game *g) {
                         }
                         break;
                     case SDL_SCANCODE_C:
-                        clear_screen();
+                        simulation_post(&(struct Command) {.type = COMMAND_CLEAR});
                         g->is_playing = false;
+                        simulation_pace(g);
                         pause_background_music();
                         play_sfx("assets/clear.wav");
                         break;
                     case SDL_SCANCODE_G:
-                        grid_randomize();
+                        simulation_post(&(struct Command) {
+                            .type = COMMAND_RANDOMIZE, .density = g->density, .seed = g->seed++});
                         play_sfx("assets/randomize.wav");
                         break;
                     case SDL_SCANCODE_N:
                         if (!g->is_playing) {
-                            update_grid();
+                            simulation_post(&(struct Command) {
+                                .type = COMMAND_STEP, .generations = (uint64_t) 1 << g->step_log2});
                             play_sfx("assets/next_gen.wav");
                         }
                         break;
@@ -1067,19 +1685,46 @@ void game_events(struct Game *g) {
                         g->is_music_playing = !g->is_music_playing;
                         break;
                     case SDL_SCANCODE_1:
-                        customize_preloaded_pattern("patterns/glider.rle", "Glider");
+                        customize_preloaded_pattern(g, "patterns/glider.rle", "Glider");
                         break;
                     case SDL_SCANCODE_2:
-                        customize_preloaded_pattern("patterns/blinker.rle", "Blinker");
+                        customize_preloaded_pattern(g, "patterns/blinker.rle", "Blinker");
                         break;
                     case SDL_SCANCODE_3:
-                        customize_preloaded_pattern("patterns/gosper_glider_gun.rle", "Gosper Glider Gun");
+                        customize_preloaded_pattern(g, "patterns/gosper_glider_gun.rle",
+                                                    "Gosper Glider Gun");
                         break;
                     case SDL_SCANCODE_UP:
-                        if (g->update_freq > 1) g->update_freq--;
-                        break;
                     case SDL_SCANCODE_DOWN:
-                        g->update_freq++;
+                        change_speed(g, g->event.key.scancode == SDL_SCANCODE_UP);
+                        break;
+                    case SDL_SCANCODE_E:
+                        simulation_post(&(struct Command) {.type = COMMAND_NEXT_ENGINE});
+                        break;
+                    case SDL_SCANCODE_T:
+                        simulation_post(&(struct Command) {.type = COMMAND_NEXT_TOPOLOGY});
+                        break;
+                    case SDL_SCANCODE_LEFTBRACKET:
+                        // Stepping a fixed number of generations per frame replaces the speed
+                        if (g->speed == 0 && g->step_log2 > 0) g->step_log2--;
+                        g->speed = 0;
+                        simulation_pace(g);
+                        break;
+                    case SDL_SCANCODE_RIGHTBRACKET:
+                        if (g->speed == 0 && g->step_log2 < LIFE_MAX_STEP_LOG2) g->step_log2++;
+                        g->speed = 0;
+                        simulation_pace(g);
+                        break;
+                    case SDL_SCANCODE_Z:
+                        simulation_post(&(struct Command) {.type = COMMAND_UNDO});
+                        break;
+                    case SDL_SCANCODE_LEFT:
+                        // Rewinding pauses, so the generations gone back to stay on screen
+                        g->is_playing = false;
+                        simulation_pace(g);
+                        pause_background_music();
+                        simulation_post(&(struct Command) {
+                            .type = COMMAND_REWIND, .generations = (uint64_t) 1 << g->step_log2});
                         break;
                     default:
                         break;
@@ -1088,12 +1733,12 @@ void game_events(struct Game *g) {
             case SDL_EVENT_MOUSE_BUTTON_DOWN: {
                 // Toggle cell state on mouse click
                 SDL_MouseButtonEvent *mouseButtonEvent = (SDL_MouseButtonEvent*) &g->event;
-                int mouseX = (int) mouseButtonEvent -> x;
-                int mouseY = (int) mouseButtonEvent -> y;
-                int x_g = mouseX / TILE_SIZE;
-                int y_g = mouseY / TILE_SIZE;
-                grid[y_g][x_g] = !(grid[y_g][x_g]);
-                play_sfx("assets/toggle.wav");
+                int x_g = (int) (mouseButtonEvent -> x / g->tile_size);
+                int y_g = (int) (mouseButtonEvent -> y / g->tile_size);
+                if (x_g >= 0 && x_g < g->view->width && y_g >= 0 && y_g < g->view->height) {
+                    simulation_post(&(struct Command) {.type = COMMAND_TOGGLE, .x = x_g, .y = y_g});
+                    play_sfx("assets/toggle.wav");
+                }
                 break;
             }
             default:
@@ -1125,48 +1770,189 @@ void game_events(struct Game *g) {
 
 // Vanshi and Khushi
 void draw_grid_lines(struct Game *g) {
+    // Lines between tiles only a few pixels wide would cover the cells themselves
+    if (g->tile_size < MIN_LINE_TILE_SIZE) return;
+    int width = g->view->width, height = g->view->height;
+    float right = width * g->tile_size, bottom = height * g->tile_size;
     SDL_SetRenderDrawColor(g->renderer, 255, 255, 255, 255);
     // Draw vertical lines
-    for (int x = 0; x < WINDOW_WIDTH; x+=TILE_SIZE) {
-        SDL_RenderLine(g->renderer, x, 0, x, WINDOW_HEIGHT);
+    for (int x = 0; x <= width; x++) {
+        SDL_RenderLine(g->renderer, x * g->tile_size, 0, x * g->tile_size, bottom);
     }
     // Draw horizontal lines
-    for (int y = 0; y < WINDOW_HEIGHT; y+=TILE_SIZE) {
-        SDL_RenderLine(g->renderer, 0, y, WINDOW_WIDTH, y);
+    for (int y = 0; y <= height; y++) {
+        SDL_RenderLine(g->renderer, 0, y * g->tile_size, right, y * g->tile_size);
     }
 }
 
 /**
- * @brief Draws all active (alive) cells in the simulation grid.
+ * @brief Returns a color as a pixel of the cell texture (SDL_PIXELFORMAT_ARGB8888).
+ */
+
+static Uint32 cell_pixel(struct Color c) {
+    return (Uint32) c.a << 24 | (Uint32) c.r << 16 | (Uint32) c.g << 8 | c.b;
+}
+
+/**
+ * @brief Fills in the pixel of every cell state.
+ *
+ * Dead cells are black and live cells use the tile color. Under a Generations rule every decay
+ * state has its own entry, fading from the tile color towards black as it ages, so the trails
+ * of dying cells stay visible.
+ *
+ * @param g Pointer to the Game structure containing the color data.
+ * @param palette Receives the pixels, indexed by state.
+ */
+
+static void cell_palette(const struct Game *g, Uint32 palette[256]) {
+    int states = g->view->has_states ? g->view->state_count : 2;
+    palette[0] = cell_pixel((struct Color) {0, 0, 0, 255});
+    for (int s = 1; s < states; s++) {
+        float shade = 1.0f - 0.8f * (float) (s - 1) / (float) (states - 1);
+        palette[s] = cell_pixel((struct Color) {
+            (Uint8) (g -> tile_color.r * shade), (Uint8) (g -> tile_color.g * shade),
+            (Uint8) (g -> tile_color.b * shade), g -> tile_color.a});
+    }
+}
+
+/**
+ * @brief Returns true if any of the cells from x0 up to (not including) x1 is set in a row.
+ */
+
+static bool any_cell(const uint64_t *row, int x0, int x1) {
+    int first = x0 / LIFE_WORD_BITS, last = (x1 - 1) / LIFE_WORD_BITS;
+    for (int i = first; i <= last; i++) {
+        uint64_t word = row[i];
+        if (i == first) word &= ~(uint64_t) 0 << (x0 % LIFE_WORD_BITS);
+        if (i == last) word &= ~(uint64_t) 0 >> (LIFE_WORD_BITS - 1 - (x1 - 1) % LIFE_WORD_BITS);
+        if (word) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Writes the cells of the view into the pixels of the cell texture.
+ *
+ * A texture as large as the grid has one texel per cell. On boards with more cells than the
+ * window has pixels, each texel stands for a block of cells instead, and shows a live cell if
+ * any cell in the block is alive (so lone gliders stay visible), otherwise the state of the
+ * block's first cell.
+ *
+ * @param g Pointer to the Game structure holding the view and the band buffer.
+ * @param pixels Locked pixels of the texture.
+ * @param pitch Bytes per row of `pixels`.
+ * @param texels_w Texture width.
+ * @param texels_h Texture height.
+ */
+
+static void fill_cell_texture(struct Game *g, void *pixels, int pitch, int texels_w,
+                              int texels_h) {
+    const struct GridView *v = g->view;
+    Uint32 palette[256];
+    cell_palette(g, palette);
+    for (int ty = 0; ty < texels_h; ty++) {
+        int y0 = (int) ((long long) v->height * ty / texels_h);
+        int y1 = (int) ((long long) v->height * (ty + 1) / texels_h);
+        Uint32 *out = (Uint32 *) ((Uint8 *) pixels + (size_t) ty * pitch);
+        const uint64_t *cells = v->cells + (size_t) y0 * v->words;
+        const uint8_t *states = v->has_states
+                                    ? v->states + (size_t) y0 * v->words * LIFE_WORD_BITS : NULL;
+        // Gather the live cells of all the rows the texel row stands for
+        if (y1 > y0 + 1) {
+            memcpy(g->cell_band, cells, (size_t) v->words * sizeof(uint64_t));
+            for (int y = y0 + 1; y < y1; y++) {
+                const uint64_t *row = v->cells + (size_t) y * v->words;
+                for (int i = 0; i < v->words; i++) g->cell_band[i] |= row[i];
+            }
+            cells = g->cell_band;
+        }
+
+        if (texels_w == v->width) {
+            for (int x = 0; x < v->width; x++) {
+                bool alive = (cells[x / LIFE_WORD_BITS] >> (x % LIFE_WORD_BITS)) & 1;
+                out[x] = palette[alive ? 1 : states ? states[x] : 0];
+            }
+            continue;
+        }
+        for (int tx = 0; tx < texels_w; tx++) {
+            int x0 = (int) ((long long) v->width * tx / texels_w);
+            int x1 = (int) ((long long) v->width * (tx + 1) / texels_w);
+            out[tx] = palette[any_cell(cells, x0, x1) ? 1 : states ? states[x0] : 0];
+        }
+    }
+}
+
+/**
+ * @brief Makes sure the cell texture exists and has the given size, and the band holds a row of
+ *        the view. On failure both are released, so nothing is drawn until they can be made.
+ * @return true if the texture is ready, false if it could not be created.
+ */
+
+static bool reserve_cell_texture(struct Game *g, int texels_w, int texels_h) {
+    if (g->cell_band_words != g->view->words) {
+        SDL_free(g->cell_band);
+        g->cell_band = SDL_malloc((size_t) g->view->words * sizeof(uint64_t));
+        g->cell_band_words = g->cell_band ? g->view->words : 0;
+    }
+    if (g->cell_band && g->cell_texture && g->cell_texture->w == texels_w &&
+        g->cell_texture->h == texels_h) {
+        return true;
+    }
+    if (g->cell_texture) SDL_DestroyTexture(g->cell_texture);
+    g->cell_texture = NULL;
+    if (g->cell_band) {
+        g->cell_texture = SDL_CreateTexture(g->renderer, SDL_PIXELFORMAT_ARGB8888,
+                                            SDL_TEXTUREACCESS_STREAMING, texels_w, texels_h);
+    }
+    if (!g->cell_texture) {
+        SDL_Log("Failed to create the %dx%d cell texture: %s\n", texels_w, texels_h,
+                SDL_GetError());
+        SDL_free(g->cell_band);
+        g->cell_band = NULL;
+        g->cell_band_words = 0;
+        return false;
+    }
+    // Cells stay sharp squares however far they are scaled, and replace what lies below them
+    SDL_SetTextureScaleMode(g->cell_texture, SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureBlendMode(g->cell_texture, SDL_BLENDMODE_NONE);
+    g->cell_texture_stale = true;
+    return true;
+}
+
+/**
+ * @brief Draws all cells of the simulation grid.
  * 
- * Iterates through the `grid` array and fills each live cell as a colored rectangle using
- * colored rectangle using the current tile color from the Game struct.
+ * The latest view published by the simulation thread is written into a streaming texture with
+ * one texel per cell whenever a new one arrives or the tile color changes, and the texture is
+ * scaled to the tiles in a single SDL_RenderTexture() call, so drawing costs the same however
+ * many cells are alive.
  * 
  * @param g Pointer to the Game structure containing the renderer and color data.
- * 
- * @note This function only draws live cells (those with value `1`).
- *       Empty cells reamin black and drawn over by the background.
  */
 
 // Vanshi and Khushi
 void draw_grid(struct Game *g) {
-    // Set draw color to the game's tile color
-    SDL_SetRenderDrawColor(g->renderer, g->tile_color.r, g->tile_color.g, g->tile_color.b, g->tile_color.a);
-    // Iterate through the grid and draw live cells
-    for (int y = 0; y < GRID_HEIGHT; y++) {
-        for (int x = 0; x < GRID_WIDTH; x++) {
-            if (grid[y][x]) {
-                // Draw filled rectangle for live cell
-                SDL_FRect rect = {
-                    .x = x * TILE_SIZE,
-                    .y = y * TILE_SIZE,
-                    .w = TILE_SIZE,
-                    .h = TILE_SIZE
-                };
-                SDL_RenderFillRect(g->renderer, &rect);
-            }
+    const struct GridView *v = g->view;
+    // Never more texels than the grid covers pixels
+    int texels_w = SDL_clamp((int) SDL_ceilf(v->width * g->tile_size), 1, v->width);
+    int texels_h = SDL_clamp((int) SDL_ceilf(v->height * g->tile_size), 1, v->height);
+    if (!reserve_cell_texture(g, texels_w, texels_h)) return;
+
+    if (g->cell_texture_stale ||
+        memcmp(&g->cell_texture_color, &g->tile_color, sizeof(g->tile_color)) != 0) {
+        void *pixels;
+        int pitch;
+        if (!SDL_LockTexture(g->cell_texture, NULL, &pixels, &pitch)) {
+            SDL_Log("Failed to lock the cell texture: %s\n", SDL_GetError());
+            return;
         }
+        fill_cell_texture(g, pixels, pitch, texels_w, texels_h);
+        SDL_UnlockTexture(g->cell_texture);
+        g->cell_texture_stale = false;
+        g->cell_texture_color = g->tile_color;
     }
+    SDL_FRect dst = {0, 0, v->width * g->tile_size, v->height * g->tile_size};
+    SDL_RenderTexture(g->renderer, g->cell_texture, NULL, &dst);
 }
 
 /**
@@ -1184,15 +1970,19 @@ void game_draw(struct Game *g) {
     SDL_RenderClear(g->renderer);
     draw_grid(g);
     draw_grid_lines(g);
+    Uint64 present_start = SDL_GetTicksNS();
     SDL_RenderPresent(g->renderer);
+    g->present_ns = SDL_GetTicksNS() - present_start;
 }
 
 /**
  * @brief Main simulation loop for the game.
  * 
  * Continuously updates the game state, processes events, and redraws the frame as long as
- * the game is running.
- * The update frequency controls how often the grid evolves to the next generation.
+ * the game is running, at FRAMES_PER_SECOND frames per second.
+ * The grid evolves on the simulation thread at the speed it was given (see
+ * simulation_advance()); each frame draws the latest generation it published, so a slow
+ * generation never holds up input or drawing.
  * 
  * @param g Pointer to the active Game structure containing window, renderer, and state
  *          information.
@@ -1202,28 +1992,426 @@ void game_draw(struct Game *g) {
 
 // Vanshi and Khushi, Prateek and Hunar
 void game_run(struct Game *g) {
-    int count = 0; // Frame counter for update frequency
-
+    Uint64 frame_start = SDL_GetTicksNS();
     while (g -> is_running) {
-        if (g -> is_playing) {
-            count++; // Increment frame counter
+        Uint64 now = SDL_GetTicksNS(), frame_ns = now - frame_start;
+        frame_start = now;
+        bool fresh;
+        g -> view = triple_buffer_latest(&sim.views, &fresh);
+        if (fresh) g -> cell_texture_stale = true;
+        const struct GridView *v = g -> view;
+
+        // Update window title based on play/pause state, rule, engine, speed and generation
+        char title[240], changes[48] = "", period[32] = "", speed[48];
+        if (g->speed == 0) {
+            snprintf(speed, sizeof(speed), "x%llu/frame", 1ull << g->step_log2);
+        } else if (g->speed >= MAX_SPEED) {
+            snprintf(speed, sizeof(speed), "max gen/s");
+        } else {
+            snprintf(speed, sizeof(speed), "%g gen/s", g->speed);
+        }
+        if (g->is_playing) {
+            size_t length = strlen(speed);
+            snprintf(speed + length, sizeof(speed) - length, " (%.0f actual)", v->rate);
         }
-        // Update grid if enough frames have passed
-        if (count >= g -> update_freq) {
-            count = 0;
-            update_grid();
+        if (v->has_changes) {
+            snprintf(changes, sizeof(changes), " | +%llu -%llu",
+                     (unsigned long long) v->births, (unsigned long long) v->deaths);
         }
-        // Update window title based on play/pause state
-        SDL_SetWindowTitle(g->window, g->is_playing? "Conway's Game of Life | Playing" : "Conway's Game of Life | Paused");
+        if (v->period) {
+            snprintf(period, sizeof(period), " | Period %llu", (unsigned long long) v->period);
+        }
+        snprintf(title, sizeof(title), "Conway's Game of Life | %s | %s | %s %s | Gen %llu%s%s",
+                 g->is_playing ? "Playing" : "Paused", v->rule, v->engine, speed,
+                 (unsigned long long) v->generation, changes, period);
+        SDL_SetWindowTitle(g->window, title);
         
-        // Handle events and draw the frame
+        // Handle events and draw the frame, and tell the simulation what it took
         game_events(g);
         game_draw(g);
+        simulation_report_frame(frame_ns, SDL_GetTicksNS() - frame_start - g->present_ns,
+                                g->present_ns);
 
-        SDL_Delay(16); // Approx ~60 FPS
+        // Sleep away what is left of the frame
+        Uint64 spent = SDL_GetTicksNS() - frame_start;
+        if (spent < FRAME_NS) SDL_DelayNS(FRAME_NS - spent);
     }
 }
 
+/* --------------------------------------------------------------------------------------------
+ * Headless Batch Mode
+ * --------------------------------------------------------------------------------------------
+ * Runs a pattern for a fixed number of generations without a window, audio or fonts, and
+ * reports the time it took. Nothing throttles the engine, unlike the frame loop of the game.
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @struct BatchCells
+ * @brief The live cells of an unbounded plane, collected for the batch results.
+ */
+
+struct BatchCells {
+    struct LifeRleCell *cells; // Live cells, in the order the engine listed them
+    size_t count; // Number of cells
+    size_t capacity; // Number of cells `cells` has room for
+    bool failed; // True if memory ran out, leaving the list incomplete
+};
+
+/**
+ * @brief Adds a live cell to a BatchCells list (a LifeCellVisitor).
+ */
+
+static void batch_add_cell(void *ctx, int64_t x, int64_t y) {
+    struct BatchCells *list = ctx;
+    if (list->failed) return;
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 1024;
+        struct LifeRleCell *cells = SDL_realloc(list->cells, capacity * sizeof(*cells));
+        if (!cells) {
+            list->failed = true;
+            return;
+        }
+        list->cells = cells;
+        list->capacity = capacity;
+    }
+    list->cells[list->count++] = (struct LifeRleCell) {x, y};
+}
+
+/**
+ * @brief Orders cells by row, then by column, as RLE lists them.
+ */
+
+static int batch_compare_cells(const void *a, const void *b) {
+    const struct LifeRleCell *p = a, *q = b;
+    if (p->y != q->y) return p->y < q->y ? -1 : 1;
+    return (p->x > q->x) - (p->x < q->x);
+}
+
+/**
+ * @brief Tells whether any live cell lies in the outermost rows or columns of the grid.
+ */
+
+static bool batch_touches_edge(const struct LifeGrid *g) {
+    for (int i = 0; i < g->words; i++) {
+        uint64_t mask = i == g->words - 1 ? g->last_mask : ~(uint64_t) 0;
+        if ((life_grid_row(g, 0)[i] | life_grid_row(g, g->height - 1)[i]) & mask) return true;
+    }
+    for (int y = 0; y < g->height; y++) {
+        if (life_grid_get(g, 0, y) || life_grid_get(g, g->width - 1, y)) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Prints the batch results and saves the final generation of an unbounded engine: the
+ *        whole plane, not just the grid window, cropped to its live cells.
+ * @return true if the results were complete and written, false otherwise.
+ */
+
+static bool batch_report_plane(const struct Options *opts, double seconds) {
+    struct BatchCells list = {0};
+    life_engine_visit_cells(&grid, batch_add_cell, &list);
+    bool ok = !list.failed;
+    if (ok) {
+        printf("generations=%llu seconds=%.6f generations_per_second=%.0f population=%llu "
+               "period=0\n", (unsigned long long) opts -> generations, seconds,
+               seconds > 0 ? (double) opts -> generations / seconds : 0.0,
+               (unsigned long long) list.count);
+        qsort(list.cells, list.count, sizeof(*list.cells), batch_compare_cells);
+    } else {
+        fprintf(stderr, "Out of memory listing the live cells of the plane\n");
+    }
+    if (ok && opts -> out[0] && !life_rle_save_cells(list.cells, list.count, &grid.rule,
+                                                       grid.generation, opts -> out)) {
+        fprintf(stderr, "%s\n", SDL_GetError());
+        ok = false;
+    }
+    SDL_free(list.cells);
+    return ok;
+}
+
+/**
+ * @brief Prints the batch results and saves the final generation of a bounded engine.
+ * @return true if the results were written, false otherwise.
+ */
+
+static bool batch_report_grid(const struct Options *opts, double seconds) {
+    if (grid.topology == LIFE_TOPOLOGY_DEAD && batch_touches_edge(&grid)) {
+        fprintf(stderr, "Warning: live cells reached the edge of the %dx%d grid, where the "
+                "pattern may have been cut short; give a larger --width and --height or use an "
+                "unbounded engine\n", grid.width, grid.height);
+    }
+    printf("generations=%llu seconds=%.6f generations_per_second=%.0f population=%llu "
+           "period=%llu\n", (unsigned long long) opts -> generations, seconds,
+           seconds > 0 ? (double) opts -> generations / seconds : 0.0,
+           (unsigned long long) life_grid_population(&grid),
+           (unsigned long long) life_grid_cycle_period(&grid));
+    if (opts -> out[0] && !life_rle_save(&grid, opts -> out)) {
+        fprintf(stderr, "%s\n", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Loads the batch pattern, advances it and writes the result.
+ *
+ * The grid defaults to the size of the pattern plus a margin of BATCH_MARGIN dead cells on
+ * every side; when its size is given with --width/--height, the pattern is placed at its centre.
+ * The timing is printed to stdout as one line of `name=value` pairs, e.g. `generations=1000
+ * seconds=0.012345 generations_per_second=81004 population=116 period=0` (period 0 meaning no
+ * cycle was detected).
+ *
+ * Unbounded engines report the population of, and save, the whole plane. On a bounded grid
+ * with dead edges a warning is printed if live cells end up on the edge, where the pattern was
+ * likely cut short.
+ *
+ * @param opts Command-line options, with `batch` naming the pattern.
+ * @return true if the run completed and the result was written, false otherwise.
+ */
+
+bool run_batch(const struct Options *opts) {
+    int pattern_w = 0, pattern_h = 0;
+    bool sized = life_rle_dimensions(opts -> batch, &pattern_w, &pattern_h);
+    int width = opts -> width ? opts -> width : sized ? pattern_w : GRID_WIDTH;
+    int height = opts -> height ? opts -> height : sized ? pattern_h : GRID_HEIGHT;
+    // The margin only goes as far as the largest grid; larger patterns are refused below
+    if (sized && !opts -> width) {
+        width = (int) SDL_min((int64_t) width + 2 * BATCH_MARGIN,
+                              SDL_max(width, LIFE_MAX_DIMENSION));
+    }
+    if (sized && !opts -> height) {
+        height = (int) SDL_min((int64_t) height + 2 * BATCH_MARGIN,
+                               SDL_max(height, LIFE_MAX_DIMENSION));
+    }
+    if (width > LIFE_MAX_DIMENSION || height > LIFE_MAX_DIMENSION) {
+        fprintf(stderr, "Pattern %s is larger than %d cells, give --width and --height\n",
+                opts -> batch, LIFE_MAX_DIMENSION);
+        return false;
+    }
+
+    bool ok = grid_new(opts, width, height);
+    if (ok) {
+        int offset_x = sized ? (width - pattern_w) / 2 : 0;
+        int offset_y = sized ? (height - pattern_h) / 2 : 0;
+        ok = load_rle(opts -> batch, offset_y, offset_x, false);
+    }
+    if (ok) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        life_engine_advance(&grid, opts -> generations);
+        double seconds = (double) (SDL_GetPerformanceCounter() - start) /
+                         (double) SDL_GetPerformanceFrequency();
+        ok = life_engine_for_grid(&grid) -> visit_cells ? batch_report_plane(opts, seconds)
+                                                         : batch_report_grid(opts, seconds);
+    }
+    life_engine_shutdown();
+    life_grid_free(&grid);
+    return ok;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Command-Line Options
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Prints the supported command-line options.
+ * @param program Name the program was started with.
+ */
+
+void print_usage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --width N        Grid width in tiles (default: %d)\n", GRID_WIDTH);
+    fprintf(stderr, "  --height N       Grid height in tiles (default: %d)\n", GRID_HEIGHT);
+    fprintf(stderr, "  --threads N      Simulation worker threads (default: one per CPU core)\n");
+    fprintf(stderr, "  --engine NAME    Stepping engine: bitwise (default), lut, temporal, hashlife or sparse\n");
+    fprintf(stderr, "  --speed N|max    Target generations per second (default: %g)\n",
+            DEFAULT_SPEED);
+    fprintf(stderr, "  --step-log2 K    Advance 2^K generations per frame instead\n");
+    fprintf(stderr, "  --topology NAME  Grid edges: dead (default), torus or klein\n");
+    fprintf(stderr, "  --rule RULE      Life-like or Generations rule in B/S[/C] notation, or Larger than\n");
+    fprintf(stderr, "                   Life rule as R,C,M,S,B,N (default: B3/S23)\n");
+    fprintf(stderr, "  --cycles on|off  Skip whole periods once the grid cycles (default: on)\n");
+    fprintf(stderr, "  --density P      Fraction of live cells in random soups (default: %g)\n",
+            DEFAULT_DENSITY);
+    fprintf(stderr, "  --seed N         Seed of the first random soup, counting up (default: 1)\n");
+    fprintf(stderr, "  --history-mb N   MiB kept for undo and rewind, 0 for none (default: %d)\n",
+            DEFAULT_HISTORY_MB);
+    fprintf(stderr, "  --batch FILE     Run the RLE pattern in FILE without a window and print the timing\n");
+    fprintf(stderr, "  --generations N  Batch mode: generations to advance (default: 0)\n");
+    fprintf(stderr, "  --out FILE       Batch mode: write the final generation to FILE as RLE\n");
+    fprintf(stderr, "  --config FILE    Read options from FILE, one \"name = value\" per line\n");
+}
+
+bool load_config(const char *filename, struct Options *opts);
+
+/**
+ * @brief Applies a single named option to an Options structure.
+ * @param name Option name without the leading dashes, e.g. "threads".
+ * @param value Option value.
+ * @param opts Options to update.
+ * @return true if the option exists and its value is valid, false otherwise.
+ */
+
+bool apply_option(const char *name, const char *value, struct Options *opts) {
+    if (strcmp(name, "width") == 0 || strcmp(name, "height") == 0) {
+        int size = atoi(value);
+        if (size < 1 || size > LIFE_MAX_DIMENSION) {
+            fprintf(stderr, "Grid %s must be between 1 and %d\n", name, LIFE_MAX_DIMENSION);
+            return false;
+        }
+        if (name[0] == 'w') opts -> width = size; else opts -> height = size;
+    } else if (strcmp(name, "threads") == 0) {
+        opts -> threads = atoi(value);
+        if (opts -> threads < 0) {
+            fprintf(stderr, "Invalid thread count: %s\n", value);
+            return false;
+        }
+    } else if (strcmp(name, "engine") == 0) {
+        SDL_strlcpy(opts -> engine, value, sizeof(opts -> engine));
+    } else if (strcmp(name, "speed") == 0) {
+        char *end;
+        opts -> speed = strcmp(value, "max") == 0 ? MAX_SPEED : strtod(value, &end);
+        if (opts -> speed != MAX_SPEED && (end == value || *end || !(opts -> speed > 0))) {
+            fprintf(stderr, "Speed must be a positive number of generations per second or max\n");
+            return false;
+        }
+        opts -> speed = SDL_min(opts -> speed, MAX_SPEED);
+    } else if (strcmp(name, "step-log2") == 0) {
+        opts -> step_log2 = atoi(value);
+        if (opts -> step_log2 < 0 || opts -> step_log2 > LIFE_MAX_STEP_LOG2) {
+            fprintf(stderr, "Step exponent must be between 0 and %d\n", LIFE_MAX_STEP_LOG2);
+            return false;
+        }
+        opts -> speed = 0; // A fixed step per frame replaces the target speed
+    } else if (strcmp(name, "topology") == 0) {
+        if (!life_topology_parse(value, &opts -> topology)) {
+            fprintf(stderr, "%s\n", SDL_GetError());
+            return false;
+        }
+    } else if (strcmp(name, "rule") == 0) {
+        if (!life_rule_parse(value, &opts -> rule)) {
+            fprintf(stderr, "%s\n", SDL_GetError());
+            return false;
+        }
+        opts -> has_rule = true;
+    } else if (strcmp(name, "cycles") == 0) {
+        if (strcmp(value, "on") != 0 && strcmp(value, "off") != 0) {
+            fprintf(stderr, "Cycle detection must be on or off\n");
+            return false;
+        }
+        opts -> no_cycles = strcmp(value, "off") == 0;
+    } else if (strcmp(name, "density") == 0) {
+        char *end;
+        opts -> density = strtod(value, &end);
+        if (end == value || *end || !(opts -> density >= 0 && opts -> density <= 1)) {
+            fprintf(stderr, "Density must be between 0 and 1\n");
+            return false;
+        }
+    } else if (strcmp(name, "seed") == 0) {
+        char *end;
+        opts -> seed = strtoull(value, &end, 10);
+        if (!isdigit((unsigned char) value[0]) || *end) {
+            fprintf(stderr, "Invalid seed: %s\n", value);
+            return false;
+        }
+    } else if (strcmp(name, "history-mb") == 0) {
+        opts -> history_mb = atoi(value);
+        if (opts -> history_mb < 0 || opts -> history_mb > 1 << 20 ||
+            !isdigit((unsigned char) value[0])) {
+            fprintf(stderr, "History size must be between 0 and %d MiB\n", 1 << 20);
+            return false;
+        }
+    } else if (strcmp(name, "batch") == 0) {
+        SDL_strlcpy(opts -> batch, value, sizeof(opts -> batch));
+    } else if (strcmp(name, "generations") == 0) {
+        char *end;
+        opts -> generations = strtoull(value, &end, 10);
+        if (!isdigit((unsigned char) value[0]) || *end) {
+            fprintf(stderr, "Invalid generation count: %s\n", value);
+            return false;
+        }
+    } else if (strcmp(name, "out") == 0) {
+        SDL_strlcpy(opts -> out, value, sizeof(opts -> out));
+    } else if (strcmp(name, "config") == 0) {
+        return load_config(value, opts);
+    } else {
+        fprintf(stderr, "Unknown option: %s\n", name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads options from a configuration file.
+ *
+ * Each line holds one `name = value` pair using the command-line option names without the
+ * leading dashes (e.g. `width = 20000`). Blank lines and everything after a `#` are ignored.
+ *
+ * @param filename Path to the configuration file.
+ * @param opts Options to update.
+ * @return true if the file was read and all options were valid, false otherwise.
+ */
+
+bool load_config(const char *filename, struct Options *opts) {
+    FILE *f = fopen(filename, "r");
+    if (!f) {
+        fprintf(stderr, "Error opening config file: %s\n", filename);
+        return false;
+    }
+
+    char line[256];
+    int line_number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        line_number++;
+        line[strcspn(line, "#\r\n")] = '\0';
+
+        // Split at '=' and trim the whitespace around the name and the value
+        char *name = line, *value = strchr(line, '=');
+        while (isspace((unsigned char) *name)) name++;
+        if (!*name) continue;
+        if (!value) {
+            fprintf(stderr, "%s:%d: expected name = value\n", filename, line_number);
+            ok = false;
+            break;
+        }
+        char *name_end = value++;
+        while (name_end > name && isspace((unsigned char) name_end[-1])) name_end--;
+        *name_end = '\0';
+        while (isspace((unsigned char) *value)) value++;
+        char *value_end = value + strlen(value);
+        while (value_end > value && isspace((unsigned char) value_end[-1])) value_end--;
+        *value_end = '\0';
+
+        if (!apply_option(name, value, opts)) {
+            fprintf(stderr, "%s:%d: invalid setting '%s'\n", filename, line_number, name);
+            ok = false;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+/**
+ * @brief Parses the command-line arguments into an Options structure.
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line argument strings.
+ * @param opts Options to fill in; fields not given on the command line keep their defaults.
+ * @return true if all arguments were valid, false otherwise.
+ */
+
+bool parse_options(int argc, char *argv[], struct Options *opts) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0 || i + 1 >= argc) {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+        const char *name = argv[i] + 2;
+        if (!apply_option(name, argv[++i], opts)) return false;
+    }
+    return true;
+}
+
 /* --------------------------------------------------------------------------------------------
  * Program Entry Point
  * -------------------------------------------------------------------------------------------- */
@@ -1249,9 +2437,22 @@ int main(int argc, char *argv[]) {
     bool exit_status = EXIT_FAILURE; // Default to failure
 
     struct Game game = {0};
+    struct Options opts = {.speed = DEFAULT_SPEED, .density = DEFAULT_DENSITY, .seed = 1,
+                           .history_mb = DEFAULT_HISTORY_MB};
+
+    // Parse command-line options
+    if (!parse_options(argc, argv, &opts)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Batch mode runs without any of the game's windows or audio
+    if (opts.batch[0]) {
+        return run_batch(&opts) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
     // Initialize game components
-    if (game_new(&game)) {
+    if (game_new(&game, &opts)) {
         game_run(&game);
         exit_status = EXIT_SUCCESS; // Set success if run completes
     }
@@ -0,0 +1,428 @@
+/**
+ * @file sparse_universe.c
+ * @brief Unbounded Game of Life universe stored as a hash map of bit-packed chunks.
+ *
+ * Each chunk holds 64 rows of one 64-bit word, i.e. a 64x64 block of cells, using the same bit
+ * layout as the grid: cell (x, y) of the universe is bit `x mod 64` of row `y mod 64` in chunk
+ * (floor(x / 64), floor(y / 64)). A step visits every live chunk, plus each neighbouring chunk
+ * that a live border cell could spill into, and writes the non-empty results into a fresh map.
+ * Chunks that end up empty are simply not carried over.
+ */
+
+#include "sparse_universe.h" // for sparse universe declarations
+#include "life_kernel.h" // for the word-parallel next-generation kernel
+#include <SDL3/SDL.h> // for SDL memory functions
+#include <string.h>
+
+#define SPARSE_CHUNK_SIZE 64 // Side length of a chunk in cells
+#define SPARSE_EMPTY_KEY 0x8000000080000000ull // Key of an unused map slot (chunk INT32_MIN, INT32_MIN)
+
+/* --------------------------------------------------------------------------------------------
+ * Struct Definitions
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @struct SparseChunk
+ * @brief A 64x64 block of cells, one word per row.
+ */
+
+struct SparseChunk {
+    uint64_t rows[SPARSE_CHUNK_SIZE]; // Cell rows, bit 0 is the westmost cell
+    struct SparseChunk *next_free; // Link in the free list while unused
+};
+
+/**
+ * @struct SparseMap
+ * @brief Open-addressing (linear probing) hash map from chunk coordinates to chunks.
+ *
+ * The map is also used as a plain key set while collecting the chunks to compute, in which case
+ * the chunk pointers are NULL.
+ */
+
+struct SparseMap {
+    uint64_t *keys; // Packed chunk coordinates, SPARSE_EMPTY_KEY for unused slots
+    struct SparseChunk **chunks; // Chunk stored under each key
+    size_t capacity; // Number of slots (power of two)
+    size_t count; // Number of used slots
+};
+
+/* --------------------------------------------------------------------------------------------
+ * Global State
+ * -------------------------------------------------------------------------------------------- */
+
+static struct SparseMap universe = {0}; // Live chunks of the current generation
+static struct SparseChunk *free_chunks = NULL; // Chunks available for reuse
+static const struct SparseChunk empty_chunk = {{0}, NULL}; // Stand-in for missing neighbours
+static struct LifeRuleProgram rule_program; // Compiled rule of the grid being advanced
+static bool universe_loaded = false; // False until the universe has been read from the grid
+static uint64_t synced_edits = 0; // Grid edit counter when the universe last matched the grid
+
+/* --------------------------------------------------------------------------------------------
+ * Chunk Map
+ * -------------------------------------------------------------------------------------------- */
+
+static uint64_t sparse_key(int32_t cx, int32_t cy) {
+    return ((uint64_t) (uint32_t) cx << 32) | (uint32_t) cy;
+}
+
+static int32_t sparse_key_x(uint64_t key) {
+    return (int32_t) (uint32_t) (key >> 32);
+}
+
+static int32_t sparse_key_y(uint64_t key) {
+    return (int32_t) (uint32_t) key;
+}
+
+static size_t sparse_slot(uint64_t key, size_t capacity) {
+    key *= 0x9E3779B97F4A7C15ull;
+    return (size_t) (key ^ (key >> 32)) & (capacity - 1);
+}
+
+static void sparse_map_free(struct SparseMap *m) {
+    SDL_free(m->keys);
+    SDL_free(m->chunks);
+    memset(m, 0, sizeof(*m));
+}
+
+static bool sparse_map_init(struct SparseMap *m, size_t capacity) {
+    m->keys = SDL_malloc(capacity * sizeof(*m->keys));
+    m->chunks = SDL_calloc(capacity, sizeof(*m->chunks));
+    m->capacity = capacity;
+    m->count = 0;
+    if (!m->keys || !m->chunks) {
+        sparse_map_free(m);
+        return false;
+    }
+    for (size_t i = 0; i < capacity; i++) m->keys[i] = SPARSE_EMPTY_KEY;
+    return true;
+}
+
+/**
+ * @brief Returns the slot holding `key`, or the empty slot where it would be inserted.
+ */
+
+static size_t sparse_map_probe(const struct SparseMap *m, uint64_t key) {
+    size_t i = sparse_slot(key, m->capacity);
+    while (m->keys[i] != key && m->keys[i] != SPARSE_EMPTY_KEY) {
+        i = (i + 1) & (m->capacity - 1);
+    }
+    return i;
+}
+
+static struct SparseChunk *sparse_map_get(const struct SparseMap *m, uint64_t key) {
+    if (!m->capacity) return NULL;
+    return m->chunks[sparse_map_probe(m, key)];
+}
+
+/**
+ * @brief Inserts or replaces `key`, growing the map to keep it at most half full.
+ * @return false if the map could not grow.
+ */
+
+static bool sparse_map_put(struct SparseMap *m, uint64_t key, struct SparseChunk *chunk) {
+    if ((m->count + 1) * 2 > m->capacity) {
+        struct SparseMap grown;
+        if (!sparse_map_init(&grown, m->capacity ? m->capacity * 2 : 256)) return false;
+        for (size_t i = 0; i < m->capacity; i++) {
+            if (m->keys[i] == SPARSE_EMPTY_KEY) continue;
+            size_t j = sparse_map_probe(&grown, m->keys[i]);
+            grown.keys[j] = m->keys[i];
+            grown.chunks[j] = m->chunks[i];
+            grown.count++;
+        }
+        sparse_map_free(m);
+        *m = grown;
+    }
+    size_t i = sparse_map_probe(m, key);
+    if (m->keys[i] == SPARSE_EMPTY_KEY) m->count++;
+    m->keys[i] = key;
+    m->chunks[i] = chunk;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Chunk Allocation
+ * -------------------------------------------------------------------------------------------- */
+
+static struct SparseChunk *sparse_chunk_alloc(void) {
+    struct SparseChunk *c = free_chunks;
+    if (c) {
+        free_chunks = c->next_free;
+    } else {
+        c = SDL_malloc(sizeof(*c));
+        if (!c) return NULL;
+    }
+    memset(c->rows, 0, sizeof(c->rows));
+    c->next_free = NULL;
+    return c;
+}
+
+static void sparse_chunk_release(struct SparseChunk *c) {
+    c->next_free = free_chunks;
+    free_chunks = c;
+}
+
+/**
+ * @brief Returns the chunk at (cx, cy), allocating an empty one if it does not exist yet.
+ */
+
+static struct SparseChunk *sparse_chunk_at(int32_t cx, int32_t cy) {
+    uint64_t key = sparse_key(cx, cy);
+    struct SparseChunk *c = sparse_map_get(&universe, key);
+    if (c) return c;
+    c = sparse_chunk_alloc();
+    if (!c) return NULL;
+    if (!sparse_map_put(&universe, key, c)) {
+        sparse_chunk_release(c);
+        return NULL;
+    }
+    return c;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Stepping
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Computes the next generation of the centre chunk of a 3x3 chunk neighbourhood.
+ * @param n Neighbourhood, n[1][1] being the chunk itself. Missing chunks point at an empty one.
+ * @param out Destination rows.
+ * @return true if any cell of the result is alive.
+ */
+
+static bool sparse_chunk_next(const struct SparseChunk *n[3][3], uint64_t *out) {
+    const struct LifeRuleProgram *program = &rule_program;
+    uint64_t any = 0;
+    for (int r = 0; r < SPARSE_CHUNK_SIZE; r++) {
+        // The row above the first row comes from the chunks to the north, and so on
+        int ay = r > 0 ? 1 : 0, ar = r > 0 ? r - 1 : SPARSE_CHUNK_SIZE - 1;
+        int by = r + 1 < SPARSE_CHUNK_SIZE ? 1 : 2, br = r + 1 < SPARSE_CHUNK_SIZE ? r + 1 : 0;
+        out[r] = life_next_word(program, n[ay][0]->rows[ar], n[ay][1]->rows[ar], n[ay][2]->rows[ar],
+                                n[1][0]->rows[r], n[1][1]->rows[r], n[1][2]->rows[r],
+                                n[by][0]->rows[br], n[by][1]->rows[br], n[by][2]->rows[br]);
+        any |= out[r];
+    }
+    return any != 0;
+}
+
+/**
+ * @brief Adds a live chunk and every neighbour its border cells can reach to `set`.
+ */
+
+static bool sparse_add_candidates(struct SparseMap *set, int32_t cx, int32_t cy,
+                                  const struct SparseChunk *c) {
+    uint64_t west = 0, east = 0, all = 0;
+    for (int r = 0; r < SPARSE_CHUNK_SIZE; r++) {
+        west |= c->rows[r] & 1;
+        east |= c->rows[r] >> 63;
+        all |= c->rows[r];
+    }
+    if (!all) return true; // Emptied by an edit; nothing can be born around it
+
+    uint64_t top = c->rows[0], bottom = c->rows[SPARSE_CHUNK_SIZE - 1];
+    bool reach[3][3] = {
+        {top & 1, top != 0, top >> 63},
+        {west != 0, true, east != 0},
+        {bottom & 1, bottom != 0, bottom >> 63},
+    };
+    for (int dy = 0; dy < 3; dy++) {
+        for (int dx = 0; dx < 3; dx++) {
+            if (reach[dy][dx] && !sparse_map_put(set, sparse_key(cx + dx - 1, cy + dy - 1), NULL)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Advances the universe by one generation.
+ * @return false if memory ran out (the universe is then left unchanged).
+ */
+
+static bool sparse_step(void) {
+    struct SparseMap candidates = {0}, next = {0};
+    bool ok = true;
+
+    // Collect every chunk that can hold a live cell next generation
+    for (size_t i = 0; ok && i < universe.capacity; i++) {
+        if (universe.keys[i] == SPARSE_EMPTY_KEY) continue;
+        ok = sparse_add_candidates(&candidates, sparse_key_x(universe.keys[i]),
+                                   sparse_key_y(universe.keys[i]), universe.chunks[i]);
+    }
+
+    // Compute each candidate from its 3x3 neighbourhood and keep the non-empty results
+    for (size_t i = 0; ok && i < candidates.capacity; i++) {
+        if (candidates.keys[i] == SPARSE_EMPTY_KEY) continue;
+        int32_t cx = sparse_key_x(candidates.keys[i]), cy = sparse_key_y(candidates.keys[i]);
+        const struct SparseChunk *n[3][3];
+        for (int dy = 0; dy < 3; dy++) {
+            for (int dx = 0; dx < 3; dx++) {
+                const struct SparseChunk *c = sparse_map_get(&universe, sparse_key(cx + dx - 1, cy + dy - 1));
+                n[dy][dx] = c ? c : &empty_chunk;
+            }
+        }
+
+        uint64_t rows[SPARSE_CHUNK_SIZE];
+        if (!sparse_chunk_next(n, rows)) continue;
+        struct SparseChunk *c = sparse_chunk_alloc();
+        if (!c || !sparse_map_put(&next, candidates.keys[i], c)) {
+            if (c) sparse_chunk_release(c);
+            ok = false;
+            break;
+        }
+        memcpy(c->rows, rows, sizeof(rows));
+    }
+    sparse_map_free(&candidates);
+
+    // Swap generations, recycling whichever chunks are no longer needed
+    struct SparseMap *dead = ok ? &universe : &next;
+    for (size_t i = 0; i < dead->capacity; i++) {
+        if (dead->keys[i] != SPARSE_EMPTY_KEY) sparse_chunk_release(dead->chunks[i]);
+    }
+    sparse_map_free(dead);
+    if (ok) {
+        universe = next;
+    } else {
+        SDL_Log("Sparse universe: out of memory, generation skipped\n");
+    }
+    return ok;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Grid Window
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Overwrites the grid window of the universe with the grid contents.
+ *
+ * Grid words map one-to-one onto chunk rows since both are 64 cells wide and the window starts
+ * at a chunk boundary. Cells outside the window are left untouched.
+ */
+
+static void sparse_load_grid(const struct LifeGrid *g) {
+    int chunk_rows = (g->height + SPARSE_CHUNK_SIZE - 1) / SPARSE_CHUNK_SIZE;
+    for (int cy = 0; cy < chunk_rows; cy++) {
+        for (int cx = 0; cx < g->words; cx++) {
+            uint64_t edge = cx == g->words - 1 ? g->last_mask : ~(uint64_t) 0;
+            uint64_t rows[SPARSE_CHUNK_SIZE], masks[SPARSE_CHUNK_SIZE], any = 0;
+            for (int r = 0; r < SPARSE_CHUNK_SIZE; r++) {
+                int y = cy * SPARSE_CHUNK_SIZE + r;
+                masks[r] = y < g->height ? edge : 0;
+                rows[r] = y < g->height ? life_grid_row(g, y)[cx] : 0;
+                any |= rows[r];
+            }
+
+            struct SparseChunk *c = sparse_map_get(&universe, sparse_key(cx, cy));
+            if (!c && !any) continue;
+            if (!c && !(c = sparse_chunk_at(cx, cy))) {
+                SDL_Log("Sparse universe: out of memory loading the grid\n");
+                return;
+            }
+            for (int r = 0; r < SPARSE_CHUNK_SIZE; r++) {
+                c->rows[r] = (c->rows[r] & ~masks[r]) | (rows[r] & masks[r]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copies the part of the universe under the grid window into the grid.
+ */
+
+static void sparse_store_grid(struct LifeGrid *g) {
+    life_grid_clear(g);
+    for (size_t i = 0; i < universe.capacity; i++) {
+        if (universe.keys[i] == SPARSE_EMPTY_KEY) continue;
+        int32_t cx = sparse_key_x(universe.keys[i]), cy = sparse_key_y(universe.keys[i]);
+        if (cx < 0 || cy < 0 || cx >= g->words || (int64_t) cy * SPARSE_CHUNK_SIZE >= g->height) {
+            continue;
+        }
+        uint64_t edge = cx == g->words - 1 ? g->last_mask : ~(uint64_t) 0;
+        for (int r = 0; r < SPARSE_CHUNK_SIZE && cy * SPARSE_CHUNK_SIZE + r < g->height; r++) {
+            life_grid_row(g, cy * SPARSE_CHUNK_SIZE + r)[cx] = universe.chunks[i]->rows[r] & edge;
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Engine Entry Points
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Advances the grid by the given number of generations on the unbounded universe.
+ *
+ * The grid window is merged into the universe first if it was edited since the last call.
+ *
+ * @param g Grid whose window is displayed; it is overwritten with the new generation.
+ * @param generations Number of generations to advance.
+ */
+
+void sparse_advance(struct LifeGrid *g, uint64_t generations) {
+    if (!universe_loaded || g->edits != synced_edits) {
+        sparse_load_grid(g);
+        universe_loaded = true;
+    }
+    rule_program = g->program;
+    for (uint64_t i = 0; i < generations; i++) {
+        if (!sparse_step()) break;
+    }
+    sparse_store_grid(g);
+    synced_edits = g->edits;
+}
+
+/**
+ * @brief Sets a cell of the universe directly, e.g. a pattern cell outside the grid window.
+ * @param x Universe X-coordinate (the grid window starts at 0).
+ * @param y Universe Y-coordinate.
+ * @param alive New state of the cell.
+ */
+
+void sparse_set_cell(int64_t x, int64_t y, bool alive) {
+    // Floor division, so that negative coordinates land in the chunk to the west/north
+    int64_t cx = (x >= 0 ? x : x - (SPARSE_CHUNK_SIZE - 1)) / SPARSE_CHUNK_SIZE;
+    int64_t cy = (y >= 0 ? y : y - (SPARSE_CHUNK_SIZE - 1)) / SPARSE_CHUNK_SIZE;
+    if (cx < INT32_MIN + 1 || cx > INT32_MAX - 1 || cy < INT32_MIN + 1 || cy > INT32_MAX - 1) return;
+
+    struct SparseChunk *c = sparse_chunk_at((int32_t) cx, (int32_t) cy);
+    if (!c) return;
+    uint64_t bit = (uint64_t) 1 << (x - cx * SPARSE_CHUNK_SIZE);
+    uint64_t *row = &c->rows[y - cy * SPARSE_CHUNK_SIZE];
+    *row = alive ? (*row | bit) : (*row & ~bit);
+}
+
+/**
+ * @brief Lists every live cell of the universe, inside the grid window or not.
+ * @param visit Called once per live cell.
+ * @param ctx Passed on to `visit`.
+ */
+
+void sparse_visit_cells(LifeCellVisitor visit, void *ctx) {
+    for (size_t i = 0; i < universe.capacity; i++) {
+        if (universe.keys[i] == SPARSE_EMPTY_KEY) continue;
+        int64_t x0 = (int64_t) sparse_key_x(universe.keys[i]) * SPARSE_CHUNK_SIZE;
+        int64_t y0 = (int64_t) sparse_key_y(universe.keys[i]) * SPARSE_CHUNK_SIZE;
+        for (int r = 0; r < SPARSE_CHUNK_SIZE; r++) {
+            for (uint64_t row = universe.chunks[i]->rows[r]; row; row &= row - 1) {
+                visit(ctx, x0 + life_popcount((row & (~row + 1)) - 1), y0 + r);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Frees the whole universe.
+ */
+
+void sparse_reset(void) {
+    for (size_t i = 0; i < universe.capacity; i++) {
+        if (universe.keys[i] != SPARSE_EMPTY_KEY) SDL_free(universe.chunks[i]);
+    }
+    sparse_map_free(&universe);
+    while (free_chunks) {
+        struct SparseChunk *next = free_chunks->next_free;
+        SDL_free(free_chunks);
+        free_chunks = next;
+    }
+    universe_loaded = false;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file sparse_universe.h
+ * @brief Declarations for the unbounded sparse-universe stepping engine.
+ *
+ * The universe is made of 64x64 bit-packed chunks kept in an open-addressing hash map keyed by
+ * chunk coordinates. Chunks are only allocated where something is alive and are dropped again
+ * as soon as they empty, so memory follows the live area rather than its bounding box. As with
+ * HashLife, the grid is a window onto the universe at cell (0, 0).
+ */
+
+#ifndef SPARSE_UNIVERSE_H
+#define SPARSE_UNIVERSE_H
+
+#include "life_engine.h" // for the grid the engine reads and writes
+#include <stdbool.h>
+#include <stdint.h>
+
+void sparse_advance(struct LifeGrid *g, uint64_t generations);
+void sparse_set_cell(int64_t x, int64_t y, bool alive);
+void sparse_reset(void);
+void sparse_visit_cells(LifeCellVisitor visit, void *ctx);
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * @file thread_pool.c
+ * @brief Persistent worker thread pool built on SDL threads.
+ *
+ * The calling thread always acts as worker 0, so a pool of N threads creates N - 1 SDL threads.
+ * Each call to thread_pool_run() publishes a job, releases the workers through a barrier, runs
+ * its own share and waits on the same barrier until every worker has finished.
+ */
+
+#include "thread_pool.h" // for thread pool declarations
+#include <SDL3/SDL.h> // for SDL main functionalities
+#include <SDL3/SDL_thread.h> // for SDL threading
+
+/* --------------------------------------------------------------------------------------------
+ * Barrier
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @struct Barrier
+ * @brief Reusable barrier: every participant blocks until all `count` have arrived.
+ */
+
+struct Barrier {
+    SDL_Mutex *mutex; // Protects the fields below
+    SDL_Condition *cond; // Signalled when the last participant arrives
+    int count; // Number of participants
+    int waiting; // Participants that have arrived in the current phase
+    unsigned phase; // Incremented every time the barrier opens
+};
+
+static bool barrier_init(struct Barrier *b, int count) {
+    b->mutex = SDL_CreateMutex();
+    b->cond = SDL_CreateCondition();
+    b->count = count;
+    b->waiting = 0;
+    b->phase = 0;
+    return b->mutex && b->cond;
+}
+
+static void barrier_destroy(struct Barrier *b) {
+    if (b->cond) SDL_DestroyCondition(b->cond);
+    if (b->mutex) SDL_DestroyMutex(b->mutex);
+    b->cond = NULL;
+    b->mutex = NULL;
+}
+
+static void barrier_wait(struct Barrier *b) {
+    SDL_LockMutex(b->mutex);
+    unsigned phase = b->phase;
+    if (++b->waiting == b->count) {
+        // Last to arrive opens the barrier for everyone
+        b->waiting = 0;
+        b->phase++;
+        SDL_BroadcastCondition(b->cond);
+    } else {
+        while (phase == b->phase) {
+            SDL_WaitCondition(b->cond, b->mutex);
+        }
+    }
+    SDL_UnlockMutex(b->mutex);
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Global State
+ * -------------------------------------------------------------------------------------------- */
+
+static SDL_Thread **workers = NULL; // Worker threads (the caller is worker 0 and not stored)
+static int *worker_ids = NULL; // Index passed to each worker thread
+static int pool_size = 1; // Number of workers including the caller
+static struct Barrier barrier = {0}; // Start/finish barrier shared by all workers
+static ThreadPoolJob current_job = NULL; // Job published by thread_pool_run()
+static void *current_ctx = NULL; // Context for the current job
+static bool pool_quit = false; // Tells the workers to exit at the next start barrier
+
+/* --------------------------------------------------------------------------------------------
+ * Internal Thread Function
+ * -------------------------------------------------------------------------------------------- */
+
+static int worker_thread(void *arg) {
+    int index = *(int *) arg;
+    while (true) {
+        barrier_wait(&barrier); // Wait for a job (or shutdown)
+        if (pool_quit) break;
+        current_job(current_ctx, index, pool_size);
+        barrier_wait(&barrier); // Report completion
+    }
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Pool Lifecycle
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Starts a pool with the given number of workers, replacing any existing pool.
+ * @param threads Number of workers including the calling thread. Values below 1 use the
+ *                number of logical CPU cores.
+ * @return true if all worker threads were started, false otherwise (the pool then runs jobs
+ *         on the calling thread only).
+ */
+
+bool thread_pool_init(int threads) {
+    thread_pool_shutdown();
+    if (threads < 1) threads = SDL_GetNumLogicalCPUCores();
+    if (threads <= 1) return true;
+
+    if (!barrier_init(&barrier, threads)) {
+        barrier_destroy(&barrier);
+        return false;
+    }
+    workers = SDL_calloc(threads, sizeof(*workers));
+    worker_ids = SDL_calloc(threads, sizeof(*worker_ids));
+    if (!workers || !worker_ids) {
+        SDL_free(workers);
+        SDL_free(worker_ids);
+        workers = NULL;
+        worker_ids = NULL;
+        barrier_destroy(&barrier);
+        return false;
+    }
+
+    pool_quit = false;
+    pool_size = threads;
+    for (int i = 1; i < threads; i++) {
+        worker_ids[i] = i;
+        workers[i] = SDL_CreateThread(worker_thread, "LifeWorker", &worker_ids[i]);
+        if (!workers[i]) {
+            SDL_Log("Failed to create worker thread: %s\n", SDL_GetError());
+            // Shrink the barrier to the workers that did start and release them
+            SDL_LockMutex(barrier.mutex);
+            pool_size = i;
+            barrier.count = i;
+            SDL_UnlockMutex(barrier.mutex);
+            thread_pool_shutdown();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Stops and joins all worker threads. Jobs run on the calling thread afterwards.
+ */
+
+void thread_pool_shutdown(void) {
+    if (workers) {
+        pool_quit = true;
+        barrier_wait(&barrier); // Release the workers so they can see the quit flag
+        for (int i = 1; i < pool_size; i++) {
+            if (workers[i]) SDL_WaitThread(workers[i], NULL);
+        }
+        SDL_free(workers);
+        SDL_free(worker_ids);
+        workers = NULL;
+        worker_ids = NULL;
+        barrier_destroy(&barrier);
+    }
+    pool_size = 1;
+    pool_quit = false;
+}
+
+/**
+ * @brief Returns the number of workers, including the calling thread.
+ */
+
+int thread_pool_size(void) {
+    return pool_size;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Job Dispatch
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Runs `job` on every worker and returns once all of them have finished.
+ * @param job Function called as `job(ctx, index, count)` on each worker.
+ * @param ctx Context pointer passed to the job.
+ */
+
+void thread_pool_run(ThreadPoolJob job, void *ctx) {
+    if (!workers) {
+        job(ctx, 0, 1);
+        return;
+    }
+    current_job = job;
+    current_ctx = ctx;
+    barrier_wait(&barrier); // Start the workers
+    job(ctx, 0, pool_size);
+    barrier_wait(&barrier); // Wait for every band to finish
+}
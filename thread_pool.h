@@ -0,0 +1,29 @@
+/**
+ * @file thread_pool.h
+ * @brief Declarations for the persistent worker thread pool.
+ *
+ * The pool keeps a fixed set of SDL threads alive for the whole run so that splitting a
+ * generation across cores does not pay thread creation costs every step. Work is handed out
+ * as a single job that every worker runs with its own index, followed by a barrier.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdbool.h>
+
+/**
+ * @brief A job run by every worker of the pool.
+ * @param ctx Caller-supplied context pointer.
+ * @param index Index of the worker running the job, from 0 to `count - 1`.
+ * @param count Total number of workers running the job.
+ */
+
+typedef void (*ThreadPoolJob)(void *ctx, int index, int count);
+
+bool thread_pool_init(int threads);
+void thread_pool_run(ThreadPoolJob job, void *ctx);
+int thread_pool_size(void);
+void thread_pool_shutdown(void);
+
+#endif
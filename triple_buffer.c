@@ -0,0 +1,58 @@
+/**
+ * @file triple_buffer.c
+ * @brief Lock-free triple buffer built on an atomic exchange of slot indices.
+ *
+ * Both sides only ever exchange their own slot index with the middle one, so each slot belongs
+ * to exactly one of the writer, the middle and the reader at any time.
+ */
+
+#include "triple_buffer.h" // for triple buffer declarations
+
+#define TRIPLE_BUFFER_FRESH 4 // Set in `middle` while it holds a slot the reader has not taken
+
+/**
+ * @brief Sets up a triple buffer over three slots. The reader starts on the first one, which
+ *        should hold something valid to show before anything is published.
+ */
+
+void triple_buffer_init(struct TripleBuffer *tb, void *first, void *second, void *third) {
+    tb->slots[0] = first;
+    tb->slots[1] = second;
+    tb->slots[2] = third;
+    tb->front = 0;
+    SDL_SetAtomicInt(&tb->middle, 1);
+    tb->back = 2;
+}
+
+/**
+ * @brief Returns the slot the writer may fill. Called by the writer thread only.
+ */
+
+void *triple_buffer_back(struct TripleBuffer *tb) {
+    return tb->slots[tb->back];
+}
+
+/**
+ * @brief Hands the filled back slot to the reader and takes the middle slot as the new back
+ *        slot. Called by the writer thread only.
+ */
+
+void triple_buffer_publish(struct TripleBuffer *tb) {
+    tb->back = SDL_SetAtomicInt(&tb->middle, tb->back | TRIPLE_BUFFER_FRESH) & ~TRIPLE_BUFFER_FRESH;
+}
+
+/**
+ * @brief Returns the most recently published slot. Called by the reader thread only; the slot
+ *        stays the reader's until the next call.
+ * @param tb Triple buffer to read.
+ * @param fresh Receives true if the slot was published since the last call (may be NULL).
+ */
+
+void *triple_buffer_latest(struct TripleBuffer *tb, bool *fresh) {
+    bool published = SDL_GetAtomicInt(&tb->middle) & TRIPLE_BUFFER_FRESH;
+    if (published) {
+        tb->front = SDL_SetAtomicInt(&tb->middle, tb->front) & ~TRIPLE_BUFFER_FRESH;
+    }
+    if (fresh) *fresh = published;
+    return tb->slots[tb->front];
+}
@@ -0,0 +1,34 @@
+/**
+ * @file triple_buffer.h
+ * @brief Declarations for the lock-free triple buffer handing data from one thread to another.
+ *
+ * One writer thread and one reader thread share three slots. The writer fills its back slot and
+ * publishes it by swapping it with the middle slot; the reader takes the middle slot whenever
+ * it holds something newer than its front slot. Neither side ever waits for the other, and the
+ * reader always sees the most recent slot published, skipping any it was too slow to see.
+ */
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <SDL3/SDL_atomic.h> // for the atomic slot exchange
+#include <stdbool.h>
+
+/**
+ * @struct TripleBuffer
+ * @brief Three slots passed between one writer and one reader.
+ */
+
+struct TripleBuffer {
+    void *slots[3]; // Caller-owned slot contents
+    SDL_AtomicInt middle; // Index of the middle slot, plus TRIPLE_BUFFER_FRESH once published
+    int back; // Index of the slot the writer fills (writer thread only)
+    int front; // Index of the slot the reader uses (reader thread only)
+};
+
+void triple_buffer_init(struct TripleBuffer *tb, void *first, void *second, void *third);
+void *triple_buffer_back(struct TripleBuffer *tb);
+void triple_buffer_publish(struct TripleBuffer *tb);
+void *triple_buffer_latest(struct TripleBuffer *tb, bool *fresh);
+
+#endif
@@ -0,0 +1,721 @@
+/**
+ * @file verify.c
+ * @brief Differential verification of the stepping engines against a naive reference.
+ *
+ * The reference counts the neighbours of every cell one by one, with the topology applied to
+ * each lookup, so it shares no code with the engines beyond the rule definition. Every engine
+ * (with every row kernel the CPU supports, for the engines built on them) is run side by side
+ * with it for every rule, topology and starting pattern: random soups, a soup large enough for
+ * the work to be split between threads, and the RLE files bundled in the patterns directory.
+ * Soups are filled by life_grid_randomize(), as in the game, and the large one is first checked
+ * to come out the same on one thread as on all of them.
+ *
+ * After every call into the engine the hashes of both grids are compared. Calls advance a
+ * random number of generations up to --max-step, so the temporally blocked and HashLife engines
+ * also take their multi-generation paths; with --max-step 1 every single generation is checked.
+ * The first divergence of each run is reported with its generation and cell. Unbounded engines
+ * are checked against a reference plane padded so that nothing reaches its edge, over a shorter
+ * run (--plane-generations) since the plane keeps growing.
+ *
+ * The bounded engines are also run a second time on the soups with cycle detection and change
+ * tracking switched on ("watched" runs), as the game uses them: whole periods are then skipped
+ * once a soup settles, which a small soup is sure to do within the run, and after every call
+ * the births and deaths recorded for the last generation are checked against the cells whose
+ * liveness changed between the last two generations of the reference.
+ *
+ * Build with `make verify`; `./verify --help` lists the options. The exit status is nonzero if
+ * any run diverged.
+ */
+
+#include <SDL3/SDL.h> // for SDL memory functions
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "life_engine.h" // for the grid and stepping engines
+#include "life_kernel.h" // for the list of row kernels
+#include "life_random.h" // for the soups and step lengths
+#include "life_rle.h" // for loading the bundled patterns
+#include "thread_pool.h" // for the number of threads reported
+
+#define VERIFY_MAX_RULES 16 // Most rules in --rules
+#define VERIFY_MAX_PATTERNS 64 // Most patterns loaded from the patterns directory
+#define VERIFY_LARGE_WIDTH 704 // Large soup: wide and tall enough to be stepped by several
+#define VERIFY_LARGE_HEIGHT 400 // threads (over 4096 words)
+#define VERIFY_SMALL_SIZE 48 // Small soup: settles into still lifes and oscillators early on
+
+/**
+ * @struct VerifyOptions
+ * @brief Harness settings parsed from the command line.
+ */
+
+struct VerifyOptions {
+    int width; // Grid width of the soups and patterns
+    int height; // Grid height of the soups and patterns
+    uint64_t generations; // Generations per run on bounded grids
+    uint64_t plane_generations; // Generations per run of the unbounded engines
+    int max_step; // Most generations advanced by one engine call
+    uint64_t seed; // Seed of the soups and step lengths
+    int threads; // Simulation worker threads (0 = one per logical CPU core)
+    char rules[512]; // Rules to check, separated by semicolons
+    char engines[256]; // Comma-separated engine names, or empty for every engine
+    char patterns[256]; // Directory holding the RLE patterns, or empty to skip them
+};
+
+/**
+ * @struct VerifyCase
+ * @brief One starting pattern: a random soup or an RLE file.
+ */
+
+struct VerifyCase {
+    char name[64]; // Name printed in the results
+    const char *path; // RLE file to load, or NULL for a random soup
+    double density; // Fraction of live cells of a random soup
+    int width; // Grid width
+    int height; // Grid height
+    int divisor; // The run lasts this many times fewer generations than usual
+    bool watched; // True to also run it with cycle detection and change tracking
+};
+
+/**
+ * @struct VerifyReference
+ * @brief The naive reference simulation: one byte per cell holding its state.
+ *
+ * For unbounded engines the stored plane extends `origin` cells beyond the grid on every side
+ * and has a dead border, which only differs from an infinite plane once a cell reaches it.
+ */
+
+struct VerifyReference {
+    int width; // Width of the stored plane
+    int height; // Height of the stored plane
+    int origin; // Position of grid cell (0, 0) along both axes of the stored plane
+    enum LifeTopology topology; // How the edges of the stored plane connect
+    struct LifeRule rule; // Rule being applied
+    uint8_t *cells; // Current states, row by row
+    uint8_t *next; // Next states, swapped with `cells` every generation
+    int neighbours; // Number of cells in the neighbourhood
+    int *neighbour_x, *neighbour_y; // Position of each neighbour relative to the cell
+    ptrdiff_t *neighbour_offset; // Index offset of each neighbour, for cells away from the edges
+    int x0, y0, x1, y1; // Bounds of the nonzero cells of `cells` (inclusive, exclusive)
+    int next_x0, next_y0, next_x1, next_y1; // Bounds of the nonzero cells of `next`
+};
+
+static uint64_t random_seed; // Seed given with --seed
+static uint64_t random_counter; // Index of the next random word of its sequence
+
+/* --------------------------------------------------------------------------------------------
+ * Reference Simulation
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Returns the next word of the sequence of the seed, so every run is reproducible.
+ */
+
+static uint64_t verify_random(void) {
+    return life_random_word(random_seed, random_counter++);
+}
+
+/**
+ * @brief Returns the state of cell (x, y) of the reference, which may lie beyond any edge, by
+ *        following the topology: a trip across the top or bottom edge of a Klein bottle mirrors
+ *        the plane left to right.
+ */
+
+static uint8_t verify_reference_get(const struct VerifyReference *r, int x, int y) {
+    bool mirrored = false;
+    if (y < 0 || y >= r->height) {
+        if (r->topology == LIFE_TOPOLOGY_DEAD) return 0;
+        int wraps = y >= 0 ? y / r->height : -((-y - 1) / r->height) - 1;
+        mirrored = r->topology == LIFE_TOPOLOGY_KLEIN && (wraps & 1);
+        y -= wraps * r->height;
+    }
+    if (x < 0 || x >= r->width) {
+        if (r->topology == LIFE_TOPOLOGY_DEAD) return 0;
+        x = (x % r->width + r->width) % r->width;
+    }
+    if (mirrored) x = r->width - 1 - x;
+    return r->cells[(size_t) y * r->width + x];
+}
+
+/**
+ * @brief Computes the next state of cell (x, y) of the reference straight from the rule.
+ */
+
+static uint8_t verify_reference_next(const struct VerifyReference *r, int x, int y) {
+    const struct LifeRule *rule = &r->rule;
+    const uint8_t *cell = r->cells + (size_t) y * r->width + x;
+    int range = rule->range ? rule->range : 1, count = 0;
+    if (x >= range && y >= range && x < r->width - range && y < r->height - range) {
+        for (int i = 0; i < r->neighbours; i++) count += cell[r->neighbour_offset[i]] == 1;
+    } else {
+        for (int i = 0; i < r->neighbours; i++) {
+            count += verify_reference_get(r, x + r->neighbour_x[i], y + r->neighbour_y[i]) == 1;
+        }
+    }
+
+    uint8_t state = *cell;
+    if (state == 0) {
+        bool born = rule->range ? count >= rule->birth_min && count <= rule->birth_max
+                                : (rule->birth >> count) & 1;
+        return born;
+    }
+    if (state == 1) {
+        bool survives = rule->range ? count >= rule->survival_min && count <= rule->survival_max
+                                    : (rule->survival >> count) & 1;
+        return survives ? 1 : rule->states > 2 ? 2 : 0;
+    }
+    return state + 1 < rule->states ? state + 1 : 0;
+}
+
+/**
+ * @brief Advances the reference by one generation. On a padded plane only the cells within
+ *        reach of the nonzero ones are computed, along with those still nonzero in the buffer
+ *        being overwritten.
+ */
+
+static void verify_reference_step(struct VerifyReference *r) {
+    int range = r->rule.range ? r->rule.range : 1;
+    int x0 = 0, y0 = 0, x1 = r->width, y1 = r->height;
+    if (r->origin) {
+        x0 = SDL_max(SDL_min(r->x0 - range, r->next_x0), 0);
+        y0 = SDL_max(SDL_min(r->y0 - range, r->next_y0), 0);
+        x1 = SDL_min(SDL_max(r->x1 + range, r->next_x1), r->width);
+        y1 = SDL_min(SDL_max(r->y1 + range, r->next_y1), r->height);
+    }
+    int nx0 = r->width, ny0 = r->height, nx1 = 0, ny1 = 0;
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            uint8_t state = verify_reference_next(r, x, y);
+            r->next[(size_t) y * r->width + x] = state;
+            if (state) {
+                nx0 = SDL_min(nx0, x);
+                ny0 = SDL_min(ny0, y);
+                nx1 = SDL_max(nx1, x + 1);
+                ny1 = SDL_max(ny1, y + 1);
+            }
+        }
+    }
+    uint8_t *cells = r->cells;
+    r->cells = r->next;
+    r->next = cells;
+    r->next_x0 = r->x0;
+    r->next_y0 = r->y0;
+    r->next_x1 = r->x1;
+    r->next_y1 = r->y1;
+    r->x0 = nx0;
+    r->y0 = ny0;
+    r->x1 = nx1;
+    r->y1 = ny1;
+}
+
+/**
+ * @brief Creates a reference holding a copy of the grid.
+ * @param padding Cells added beyond every edge (an unbounded plane), or 0 for the grid alone.
+ * @return true on success, false if memory ran out.
+ */
+
+static bool verify_reference_init(struct VerifyReference *r, const struct LifeGrid *g,
+                                  int padding) {
+    memset(r, 0, sizeof(*r));
+    r->width = g->width + 2 * padding;
+    r->height = g->height + 2 * padding;
+    r->origin = padding;
+    r->topology = padding ? LIFE_TOPOLOGY_DEAD : g->topology;
+    r->rule = g->rule;
+    r->cells = SDL_calloc((size_t) r->width * r->height, 1);
+    r->next = SDL_calloc((size_t) r->width * r->height, 1);
+    int range = r->rule.range ? r->rule.range : 1, side = 2 * range + 1;
+    r->neighbour_x = SDL_malloc((size_t) side * side * sizeof(int));
+    r->neighbour_y = SDL_malloc((size_t) side * side * sizeof(int));
+    r->neighbour_offset = SDL_malloc((size_t) side * side * sizeof(ptrdiff_t));
+    if (!r->cells || !r->next || !r->neighbour_x || !r->neighbour_y || !r->neighbour_offset) {
+        return false;
+    }
+
+    for (int dy = -range; dy <= range; dy++) {
+        for (int dx = -range; dx <= range; dx++) {
+            if (r->rule.von_neumann && abs(dx) + abs(dy) > range) continue;
+            if (dx == 0 && dy == 0 && !r->rule.middle) continue;
+            r->neighbour_x[r->neighbours] = dx;
+            r->neighbour_y[r->neighbours] = dy;
+            r->neighbour_offset[r->neighbours++] = (ptrdiff_t) dy * r->width + dx;
+        }
+    }
+    for (int y = 0; y < g->height; y++) {
+        uint8_t *row = r->cells + (size_t) (y + padding) * r->width + padding;
+        for (int x = 0; x < g->width; x++) row[x] = life_grid_get_state(g, x, y);
+    }
+    r->x0 = r->y0 = padding;
+    r->x1 = padding + g->width;
+    r->y1 = padding + g->height;
+    // Empty bounds: the other buffer is all dead
+    r->next_x0 = r->width;
+    r->next_y0 = r->height;
+    return true;
+}
+
+/**
+ * @brief Frees the memory of a reference.
+ */
+
+static void verify_reference_free(struct VerifyReference *r) {
+    SDL_free(r->cells);
+    SDL_free(r->next);
+    SDL_free(r->neighbour_x);
+    SDL_free(r->neighbour_y);
+    SDL_free(r->neighbour_offset);
+    memset(r, 0, sizeof(*r));
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Comparison
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Hashes the states of the grid with FNV-1a, row by row.
+ */
+
+static uint64_t verify_hash_grid(const struct LifeGrid *g) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (int y = 0; y < g->height; y++) {
+        for (int x = 0; x < g->width; x++) {
+            hash = (hash ^ life_grid_get_state(g, x, y)) * 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Hashes the window of the reference the grid covers, exactly like verify_hash_grid().
+ */
+
+static uint64_t verify_hash_reference(const struct VerifyReference *r, int width, int height) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = r->cells + (size_t) (y + r->origin) * r->width + r->origin;
+        for (int x = 0; x < width; x++) hash = (hash ^ row[x]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Checks the change set of a bounded grid against the last generation of the reference:
+ *        in the tiles flagged as changed, `births` and `deaths` must hold exactly the cells that
+ *        came alive and died (so `births | deaths` is the XOR of the two generations), no cell
+ *        outside them may have changed, and the counts must add up.
+ * @param r Reference, whose `next` buffer holds the generation before `cells`.
+ * @param problem Receives what was wrong, if anything.
+ * @return true if the change set is right, false otherwise.
+ */
+
+static bool verify_check_changes(const struct LifeGrid *g, const struct VerifyReference *r,
+                                 int *cell_x, int *cell_y, const char **problem) {
+    const struct LifeChangeSet *changes = &g->changes;
+    uint64_t births = 0, deaths = 0;
+    for (int y = 0; y < g->height; y++) {
+        for (int x = 0; x < g->width; x++) {
+            size_t i = (size_t) y * r->width + x;
+            bool before = r->next[i] == 1, after = r->cells[i] == 1;
+            births += !before && after;
+            deaths += before && !after;
+            size_t word = (size_t) y * g->words + x / LIFE_WORD_BITS;
+            bool flagged = g->tile_changed[(size_t) (y / LIFE_TILE_ROWS) * g->words +
+                                           x / LIFE_WORD_BITS];
+            bool born = (changes->births[word] >> (x % LIFE_WORD_BITS)) & 1;
+            bool died = (changes->deaths[word] >> (x % LIFE_WORD_BITS)) & 1;
+            if (flagged ? born != (!before && after) || died != (before && !after)
+                        : before != after) {
+                *cell_x = x;
+                *cell_y = y;
+                *problem = flagged ? "births or deaths wrong" : "change in an unflagged tile";
+                return false;
+            }
+        }
+    }
+    *cell_x = *cell_y = -1;
+    *problem = "birth or death count wrong";
+    return births == changes->birth_count && deaths == changes->death_count;
+}
+
+/**
+ * @brief Finds the first cell, in row-major order, where the grid and the reference differ.
+ * @return true if a differing cell was found.
+ */
+
+static bool verify_find_divergence(const struct LifeGrid *g, const struct VerifyReference *r,
+                                   int *cell_x, int *cell_y) {
+    for (int y = 0; y < g->height; y++) {
+        const uint8_t *row = r->cells + (size_t) (y + r->origin) * r->width + r->origin;
+        for (int x = 0; x < g->width; x++) {
+            if (life_grid_get_state(g, x, y) != row[x]) {
+                *cell_x = x;
+                *cell_y = y;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Runs
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Creates the starting grid of a case under the given rule and topology.
+ * @return true if the grid is ready, false otherwise.
+ */
+
+static bool verify_setup(struct LifeGrid *g, const struct VerifyCase *c,
+                         const struct LifeRule *rule, enum LifeTopology topology) {
+    if (!life_grid_init(g, c->width, c->height)) return false;
+    life_grid_set_topology(g, topology);
+    if (!life_grid_set_rule(g, rule)) return false;
+    if (c->path) {
+        int width = 0, height = 0;
+        life_rle_dimensions(c->path, &width, &height);
+        if (!life_rle_load(g, c->path, (c->width - width) / 2, (c->height - height) / 2)) {
+            return false;
+        }
+        // The pattern's header may have switched rules; every pattern runs under every rule
+        return life_grid_set_rule(g, rule);
+    }
+    life_grid_randomize(g, c->density, verify_random());
+    if (rule->states <= 2) return true;
+    // Soups of Generations rules also start with cells in every decay state
+    for (int y = 0; y < g->height; y++) {
+        for (int x = 0; x < g->width; x++) {
+            if (life_grid_get_state(g, x, y) != 1 || verify_random() % 2) continue;
+            uint8_t state = (uint8_t) (2 + verify_random() % (uint64_t) (rule->states - 2));
+            life_grid_set_state(g, x, y, state);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Fills the large soup on one thread and on every worker thread, and prints whether
+ *        both came out the same: random words only depend on their position, so how the rows
+ *        are split must not matter.
+ * @return true if both soups were the same, false otherwise.
+ */
+
+static bool verify_fill(const struct VerifyOptions *opts) {
+    printf("%-8s %-6s %-28s %-5s %-24s %-7s ", "fill", "-", "-", "-", "large-soup-0.35", "-");
+    fflush(stdout);
+    struct LifeGrid single = {0}, split = {0};
+    uint64_t seed = verify_random();
+    bool ready = life_grid_init(&single, VERIFY_LARGE_WIDTH, VERIFY_LARGE_HEIGHT) &&
+                 life_grid_init(&split, VERIFY_LARGE_WIDTH, VERIFY_LARGE_HEIGHT) &&
+                 life_engine_set_threads(1);
+    if (ready) {
+        life_grid_randomize(&single, 0.35, seed);
+        ready = life_engine_set_threads(opts -> threads);
+    }
+    if (!ready) {
+        printf("SKIP: %s\n", SDL_GetError());
+        life_grid_free(&single);
+        life_grid_free(&split);
+        return true;
+    }
+    life_grid_randomize(&split, 0.35, seed);
+
+    bool ok = true;
+    for (int y = 0; y < single.height && ok; y++) {
+        ok = memcmp(life_grid_row(&single, y), life_grid_row(&split, y),
+                    (size_t) single.words * sizeof(uint64_t)) == 0;
+        if (!ok) printf("FAIL in row %d on %d threads\n", y, thread_pool_size());
+    }
+    if (ok) printf("ok (1 and %d threads)\n", thread_pool_size());
+    life_grid_free(&single);
+    life_grid_free(&split);
+    return ok;
+}
+
+/**
+ * @brief Runs one engine side by side with the reference and prints the outcome.
+ * @param kernel Row kernel the engine uses, or NULL if it does not use one.
+ * @param topology Topology of the grid (ignored by unbounded engines).
+ * @param watched True to detect cycles and check the change set (bounded engines only).
+ * @return true if the engine matched the reference throughout, false otherwise.
+ */
+
+static bool verify_run(const struct VerifyOptions *opts, const struct LifeEngine *engine,
+                       const char *kernel, const char *rule_text, const struct LifeRule *rule,
+                       enum LifeTopology topology, const struct VerifyCase *c, bool watched) {
+    bool unbounded = engine->set_cell != NULL;
+    uint64_t generations = (unbounded ? opts -> plane_generations : opts -> generations) /
+                           (uint64_t) c->divisor;
+    if (kernel) life_engine_set_kernel(kernel);
+    // Engines cache the universe between calls; a fresh grid must not be mistaken for the last
+    if (engine->reset) engine->reset();
+    life_engine_select(engine->name);
+
+    printf("%-8s %-6s %-28s %-5s %-24s %-7s ", engine->name, kernel ? kernel : "-", rule_text,
+           unbounded ? "plane" : life_topology_names[topology], c->name,
+           watched ? "watched" : "-");
+    fflush(stdout);
+
+    struct LifeGrid g = {0};
+    struct VerifyReference r = {0};
+    // Nothing travels faster than `range` cells per generation, so the padding is never reached
+    int range = rule->range ? rule->range : 1;
+    int padding = unbounded ? (int) (generations * (uint64_t) range) + 1 : 0;
+    if (!verify_setup(&g, c, rule, unbounded ? LIFE_TOPOLOGY_DEAD : topology) ||
+        !verify_reference_init(&r, &g, padding)) {
+        printf("SKIP: %s\n", SDL_GetError());
+        life_grid_free(&g);
+        verify_reference_free(&r);
+        return true;
+    }
+    if (watched && (!life_grid_detect_cycles(&g, true) || !life_grid_track_changes(&g, true))) {
+        printf("SKIP: %s\n", SDL_GetError());
+        life_grid_free(&g);
+        verify_reference_free(&r);
+        return true;
+    }
+
+    bool ok = true;
+    uint64_t generation = 0;
+    while (generation < generations) {
+        uint64_t step = 1 + verify_random() % (uint64_t) opts -> max_step;
+        if (step > generations - generation) step = generations - generation;
+        life_engine_advance(&g, step);
+        for (uint64_t i = 0; i < step; i++) verify_reference_step(&r);
+        generation += step;
+
+        int x = 0, y = 0;
+        if (verify_hash_grid(&g) != verify_hash_reference(&r, g.width, g.height) &&
+            verify_find_divergence(&g, &r, &x, &y)) {
+            uint8_t expected = r.cells[(size_t) (y + r.origin) * r.width + x + r.origin];
+            printf("FAIL at generation %llu (stepped from %llu), cell (%d, %d): expected %d, "
+                   "got %d\n", (unsigned long long) generation,
+                   (unsigned long long) (generation - step), x, y, expected,
+                   life_grid_get_state(&g, x, y));
+            ok = false;
+            break;
+        }
+        // Only skipping whole periods, straight to a generation equal to one computed, leaves
+        // the change set unknown
+        const char *problem = "change set not valid";
+        if (watched && (g.changes.valid ? !verify_check_changes(&g, &r, &x, &y, &problem)
+                                        : !life_grid_cycle_period(&g))) {
+            printf("FAIL at generation %llu (stepped from %llu), cell (%d, %d): %s\n",
+                   (unsigned long long) generation, (unsigned long long) (generation - step), x,
+                   y, problem);
+            ok = false;
+            break;
+        }
+    }
+    if (ok && life_grid_cycle_period(&g)) {
+        printf("ok (%llu generations, period %llu skipped)\n", (unsigned long long) generations,
+               (unsigned long long) life_grid_cycle_period(&g));
+    } else if (ok) {
+        printf("ok (%llu generations)\n", (unsigned long long) generations);
+    }
+    life_grid_free(&g);
+    verify_reference_free(&r);
+    return ok;
+}
+
+/**
+ * @brief Returns true if the engine was asked for with --engines.
+ */
+
+static bool verify_wants_engine(const struct VerifyOptions *opts, const char *name) {
+    if (!opts -> engines[0]) return true;
+    size_t length = strlen(name);
+    for (const char *p = opts -> engines; (p = strstr(p, name)); p += length) {
+        bool starts = p == opts -> engines || p[-1] == ',';
+        if (starts && (p[length] == ',' || p[length] == '\0')) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Returns true if the engine computes generations with the row kernels, so that every
+ *        kernel must be checked with it.
+ */
+
+static bool verify_uses_kernels(const struct LifeEngine *engine) {
+    return strcmp(engine->name, "bitwise") == 0 || strcmp(engine->name, "temporal") == 0;
+}
+
+/**
+ * @brief Orders file names for qsort().
+ */
+
+static int verify_compare_names(const void *a, const void *b) {
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Command-Line Options
+ * -------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief Prints the supported command-line options.
+ */
+
+static void verify_usage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --width N              Grid width (default: 150)\n");
+    fprintf(stderr, "  --height N             Grid height (default: 100)\n");
+    fprintf(stderr, "  --generations N        Generations per run (default: 2000)\n");
+    fprintf(stderr, "  --plane-generations N  Generations per unbounded run (default: 300)\n");
+    fprintf(stderr, "  --max-step N           Most generations per engine call (default: 8)\n");
+    fprintf(stderr, "  --seed N               Seed of the soups and steps (default: 1)\n");
+    fprintf(stderr, "  --rules R;...          Rules to check, separated by semicolons\n");
+    fprintf(stderr, "  --engines NAME,...     Engines to check (default: all)\n");
+    fprintf(stderr, "  --patterns DIR         Pattern directory, or none (default: patterns)\n");
+    fprintf(stderr, "  --threads N            Worker threads (default: one per CPU core)\n");
+}
+
+/**
+ * @brief Parses the command-line arguments into `opts`.
+ * @return true if all arguments were valid, false otherwise.
+ */
+
+static bool verify_parse_options(int argc, char *argv[], struct VerifyOptions *opts) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) return false;
+        if (strncmp(argv[i], "--", 2) != 0 || i + 1 >= argc) {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+        const char *name = argv[i] + 2, *value = argv[++i];
+        if (strcmp(name, "rules") == 0) {
+            SDL_strlcpy(opts -> rules, value, sizeof(opts -> rules));
+        } else if (strcmp(name, "engines") == 0) {
+            SDL_strlcpy(opts -> engines, value, sizeof(opts -> engines));
+        } else if (strcmp(name, "patterns") == 0) {
+            SDL_strlcpy(opts -> patterns, strcmp(value, "none") == 0 ? "" : value,
+                        sizeof(opts -> patterns));
+        } else {
+            char *end;
+            unsigned long long number = strtoull(value, &end, 10);
+            bool valid = end != value && !*end;
+            if (strcmp(name, "width") == 0 || strcmp(name, "height") == 0) {
+                valid = valid && number >= 1 && number <= 4096;
+                *(name[0] == 'w' ? &opts -> width : &opts -> height) = (int) number;
+            } else if (strcmp(name, "generations") == 0) {
+                opts -> generations = number;
+            } else if (strcmp(name, "plane-generations") == 0) {
+                valid = valid && number <= 100000;
+                opts -> plane_generations = number;
+            } else if (strcmp(name, "max-step") == 0) {
+                valid = valid && number >= 1 && number <= 1024;
+                opts -> max_step = (int) number;
+            } else if (strcmp(name, "seed") == 0) {
+                opts -> seed = number;
+            } else if (strcmp(name, "threads") == 0) {
+                valid = valid && number <= 1024;
+                opts -> threads = (int) number;
+            } else {
+                fprintf(stderr, "Unknown option: %s\n", name);
+                return false;
+            }
+            if (!valid) {
+                fprintf(stderr, "Invalid %s: %s\n", name, value);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------
+ * Program Entry Point
+ * -------------------------------------------------------------------------------------------- */
+
+int main(int argc, char *argv[]) {
+    struct VerifyOptions opts = {
+        .width = 150, .height = 100, .generations = 2000, .plane_generations = 300,
+        .max_step = 8, .seed = 1, .patterns = "patterns",
+        .rules = "B3/S23;B36/S23;B2/S/C3;B3/S23/C4;R2,C0,M1,S5..9,B4..6,NM;R3,C3,M0,S4..9,B4..7,NN",
+    };
+    if (!verify_parse_options(argc, argv, &opts)) {
+        verify_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!life_engine_set_threads(opts.threads)) {
+        fprintf(stderr, "Failed to start worker threads, stepping on one thread: %s\n",
+                SDL_GetError());
+    }
+
+    // Parse the rules up front, so that a typo is reported before any run
+    char rule_texts[VERIFY_MAX_RULES][LIFE_RULE_TEXT_SIZE];
+    struct LifeRule rules[VERIFY_MAX_RULES];
+    int rule_count = 0;
+    for (char *text = strtok(opts.rules, ";"); text; text = strtok(NULL, ";")) {
+        if (rule_count == VERIFY_MAX_RULES || !life_rule_parse(text, &rules[rule_count])) {
+            fprintf(stderr, "Invalid rule list at '%s'\n", text);
+            return EXIT_FAILURE;
+        }
+        life_rule_format(&rules[rule_count], rule_texts[rule_count], LIFE_RULE_TEXT_SIZE);
+        rule_count++;
+    }
+
+    // Two soups, a small soup that settles, a large soup over a shorter run, and every bundled
+    // pattern in name order
+    struct VerifyCase cases[4 + VERIFY_MAX_PATTERNS];
+    char paths[VERIFY_MAX_PATTERNS][512];
+    int case_count = 0;
+    cases[case_count++] = (struct VerifyCase) {"soup-0.25", NULL, 0.25, opts.width, opts.height,
+                                               1, true};
+    cases[case_count++] = (struct VerifyCase) {"soup-0.50", NULL, 0.50, opts.width, opts.height,
+                                               1, true};
+    cases[case_count++] = (struct VerifyCase) {"small-soup-0.35", NULL, 0.35, VERIFY_SMALL_SIZE,
+                                               VERIFY_SMALL_SIZE, 1, true};
+    cases[case_count++] = (struct VerifyCase) {"large-soup-0.35", NULL, 0.35, VERIFY_LARGE_WIDTH,
+                                               VERIFY_LARGE_HEIGHT, 20, true};
+    int file_count = 0;
+    char **files = opts.patterns[0] ? SDL_GlobDirectory(opts.patterns, "*.rle", 0, &file_count)
+                                    : NULL;
+    if (opts.patterns[0] && !files) {
+        fprintf(stderr, "Cannot list patterns in %s: %s\n", opts.patterns, SDL_GetError());
+    }
+    if (files) qsort(files, (size_t) file_count, sizeof(char *), verify_compare_names);
+    for (int f = 0; f < file_count && f < VERIFY_MAX_PATTERNS; f++) {
+        SDL_snprintf(paths[f], sizeof(paths[f]), "%s/%s", opts.patterns, files[f]);
+        struct VerifyCase *c = &cases[case_count++];
+        *c = (struct VerifyCase) {"", paths[f], 0, opts.width, opts.height, 1, false};
+        SDL_strlcpy(c->name, files[f], sizeof(c->name));
+    }
+
+    random_seed = opts.seed;
+    int runs = 1, failures = !verify_fill(&opts);
+    for (int e = 0; e < life_engine_count; e++) {
+        const struct LifeEngine *engine = &life_engines[e];
+        if (!verify_wants_engine(&opts, engine->name)) continue;
+        bool unbounded = engine->set_cell != NULL;
+        for (int k = 0; k < life_kernel_count; k++) {
+            // Engines without row kernels are run once, with the default kernel
+            const char *kernel = verify_uses_kernels(engine) ? life_kernels[k].name : NULL;
+            if (kernel && !life_kernels[k].supported()) continue;
+            if (!kernel && k > 0) break;
+            for (int ri = 0; ri < rule_count; ri++) {
+                // Engines without extended rules would hand these to the bitwise engine
+                bool extended = rules[ri].states > 2 || rules[ri].range;
+                if (extended && !engine->extended_rules) continue;
+                for (int t = 0; t < (unbounded ? 1 : LIFE_TOPOLOGY_COUNT); t++) {
+                    for (int c = 0; c < case_count; c++) {
+                        runs++;
+                        failures += !verify_run(&opts, engine, kernel, rule_texts[ri],
+                                                &rules[ri], (enum LifeTopology) t, &cases[c],
+                                                false);
+                        if (unbounded || !cases[c].watched) continue;
+                        runs++;
+                        failures += !verify_run(&opts, engine, kernel, rule_texts[ri],
+                                                &rules[ri], (enum LifeTopology) t, &cases[c],
+                                                true);
+                    }
+                }
+            }
+        }
+    }
+    printf("%d runs, %d diverged\n", runs, failures);
+
+    SDL_free(files);
+    life_engine_shutdown();
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}